@@ -3,14 +3,15 @@
 
 #include "customer.h"
 #include "chef.h"
+#include "channel.h"
+#include "ipc_names.h"
+#include "shm_arena.h"
+#include "supply_chain.h"
 #define MAX_ITEM_NAME 25
 #define MAX_TEAM_NAME 25
 #define MAX_NAME_LENGTH 25
-#define CUSTOMER_SELLER_MSG_KEY 0x1234
-
-// define message queue keys
-#define CHEF_BAKER_KEY 0xCAFEBABE
-#define MANAGER_BAKERS 0xBEEFBEEF
+#define CUSTOMER_INBOX_MSG_KEY ipc_key(IPC_CUSTOMER_INBOX_KEY)    // SellerMessage, seller -> customer manager
+#define BAKE_CHANNEL_SHM_NAME ipc_name(IPC_BAKE_CHANNEL_SHM)
 
 
 
@@ -21,40 +22,27 @@ typedef enum Action {
     LEAVING_EARLY
 } ActionType;
 
-
-// Message structure for both files
-typedef struct {
-    long mtype;           // Message type
-    pid_t customer_pid;   // Customer identifier
-    int customer_id;      // Customer ID for logging
-    float patience;       // Current patience level
-    CustomerState state;  // Current state
-    ActionType action;           // 0: status update, 1: leaving, 2: frustrated, 3: complained, 4: missing order
-    bool in_queue;       // True if the customer is in the queue
-} CustomerStatusMsg;
-
-
-
-// Add to bakery_message.h
-typedef struct {
-    long mtype;                    // Message type
-    CustomerOrder order;           // Order details
-} OrderMessage;
-
 typedef enum {
     ORDER_SUCCESS,
     ORDER_FAILED,
     ORDER_MISSING
 } OrderResult;
 
+typedef enum {
+    SELLER_CALLING,       // The seller is ready to take the customer's order
+    ORDER_COMPLETED       // result and total_price are set
+} SellerNotice;
+
+// Seller -> customer, sent to the customer manager's inbox
 typedef struct {
-    long mtype;           // Message type (should match customer PID)
+    long mtype;           // Customer key (Customer.pid)
+    SellerNotice notice;
     OrderResult result;   // Success or failure
     float total_price;    // Total price of completed order (0 if failed)
-} CompletionMessage;
+} SellerMessage;
 
 
-int get_message_queue(void);
+int get_customer_inbox_queue(void);
 
 
 typedef struct {
@@ -64,6 +52,77 @@ typedef struct {
     int product_index;
 } ChefMessage;
 
+#define CHEF_BATCH_MAX 8   // Distinct products one batch carries
+
+typedef struct {
+    int product_index;      // Within the source team's catalog category
+    int quantity;
+} ChefBatchEntry;
+
+// What travels the chef -> baker pipeline: finished units of one chef team,
+// grouped by product. Chefs send one unit at a time; the chef manager and
+// the dispatcher merge whatever is pending before forwarding it.
+typedef struct ChefBatch {
+    long mtype;
+    ChefTeam source_team;
+    int entry_count;
+    ChefBatchEntry entries[CHEF_BATCH_MAX];
+} ChefBatch;
+
+// Add quantity units of a product; -1 if the batch has no entry left for it
+static inline int chef_batch_add(ChefBatch *batch, int product_index, int quantity) {
+    for (int i = 0; i < batch->entry_count; i++) {
+        if (batch->entries[i].product_index == product_index) {
+            batch->entries[i].quantity += quantity;
+            return 0;
+        }
+    }
+    if (batch->entry_count == CHEF_BATCH_MAX) {
+        return -1;
+    }
+    batch->entries[batch->entry_count].product_index = product_index;
+    batch->entries[batch->entry_count].quantity = quantity;
+    batch->entry_count++;
+    return 0;
+}
+
+static inline int chef_batch_units(const ChefBatch *batch) {
+    int units = 0;
+    for (int i = 0; i < batch->entry_count; i++) {
+        units += batch->entries[i].quantity;
+    }
+    return units;
+}
+
+// Channels of the chef -> baker pipeline, all in the bake channel segment
+typedef enum {
+    BAKE_CHANNEL_CHEFS,         // Chef workers -> chef manager
+    BAKE_CHANNEL_DISPATCH,      // Chef manager -> baker dispatcher
+    BAKE_CHANNEL_TEAMS,         // Dispatcher -> bakers, one channel per baker team from here
+    BAKE_CHANNEL_COUNT = BAKE_CHANNEL_TEAMS + NUM_BAKERY_TEAMS
+} BakeChannel;
+
+#define BAKE_CHANNEL_CAPACITY 64   // ChefBatches one channel holds before senders block
+
+// The launcher creates the segment (init set), every role maps it
+static inline ChannelSet *open_bake_channels(int init) {
+    return channel_set_open(BAKE_CHANNEL_SHM_NAME, BAKE_CHANNEL_COUNT, BAKE_CHANNEL_CAPACITY,
+                            sizeof(ChefBatch), init);
+}
+
+// Bakery arena: customer orders and supply orders. Room for one order per
+// customer and a backlog of supply orders, plus what every thread that
+// frees may hold in its cache.
+static inline size_t bakery_arena_size(const Config *config) {
+    size_t customers = config->MAX_CUSTOMERS > 0 ? (size_t) config->MAX_CUSTOMERS : 1;
+    size_t sellers = config->NUM_SELLERS > 0 ? (size_t) config->NUM_SELLERS : 0;
+    size_t chains = config->NUM_SUPPLY_CHAIN > 0 ? (size_t) config->NUM_SUPPLY_CHAIN : 0;
+    size_t order = shm_arena_block_size(sizeof(CustomerOrder));
+    size_t supply = shm_arena_block_size(supply_order_size(config->INGREDIENTS_TO_ORDER));
+
+    return shm_arena_size((customers + (sellers + 1) * SHM_ARENA_CACHE) * order +
+                          (chains * SUPPLY_ORDERS_PER_CHAIN + (chains + 1) * SHM_ARENA_CACHE) * supply);
+}
 
 // Message structure for restock requests
 typedef struct {
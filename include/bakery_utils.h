@@ -4,6 +4,11 @@
 
 #include "team.h"
 #include "config.h"
+#include "random.h"
+#include "channel.h"
+#include <semaphore.h>
+
+struct Game;
 
 
 
@@ -24,6 +29,12 @@ pid_t start_process_baker(const char *binary, BakerTeam *team,
                          Config *config, int mqid_from_main, int mqid_ready);
 
 
-void distribute_bakers_locally(Config *config, BakerTeam teams[NUM_BAKERY_TEAMS]);
+void distribute_bakers_locally(Config *config, BakerTeam teams[NUM_BAKERY_TEAMS], RandomStream *rng);
+
+// Baker loop, shared by the baker_worker process and the threaded runtime
+void run_baker_worker(struct Game *game, ChannelSet *channels, Team my_team, int id);
+
+// Forwards chef jobs to the bake channel of their baker team
+void run_baker_dispatcher(ChannelSet *channels);
 
 #endif // BAKER_UTILS_H
\ No newline at end of file
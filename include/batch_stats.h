@@ -0,0 +1,27 @@
+//
+// Summary statistics for a batch of independent simulation runs.
+//
+
+#ifndef BATCH_STATS_H
+#define BATCH_STATS_H
+
+typedef struct {
+    int n;
+    double mean;
+    double stddev;       // Sample standard deviation
+    double ci_low;       // 95% confidence interval of the mean (Student t)
+    double ci_high;
+    double min;
+    double p5;
+    double p50;
+    double p95;
+    double max;
+} BatchSummary;
+
+// Sorts values in place. n must be at least 1.
+void summarize_values(double *values, int n, BatchSummary *summary);
+
+// Linear interpolation between closest ranks; values must be sorted
+double percentile_sorted(const double *values, int n, double p);
+
+#endif // BATCH_STATS_H
@@ -0,0 +1,13 @@
+//
+// Cache line size and alignment for data written from several cores.
+//
+
+#ifndef CACHE_LINE_H
+#define CACHE_LINE_H
+
+#define CACHE_LINE 64
+
+// Gives a type or member its own cache line(s)
+#define CACHE_ALIGNED __attribute__((aligned(CACHE_LINE)))
+
+#endif // CACHE_LINE_H
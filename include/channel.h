@@ -0,0 +1,56 @@
+//
+// Message channels over shared memory.
+//
+// A ChannelSet is one named segment holding a fixed number of MPMC rings of
+// fixed-size messages. Sending copies the message into the segment and
+// receiving copies it out; no syscall is made unless a receiver is asleep
+// on an empty channel or a sender on a full one, in which case a futex
+// wakes it. Blocking calls yield inside a coroutine, like coro_msgrcv.
+//
+// channel_set_shutdown plays the role msgctl(IPC_RMID) played for the
+// message queues: every blocked or later call returns -1.
+//
+
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "cache_line.h"
+#include "mpmc_ring.h"
+
+typedef struct {
+    uint32_t count;             // Channels in the set
+    uint32_t capacity;          // Messages one channel holds
+    uint32_t msg_size;
+    uint32_t closed;            // Set by channel_set_shutdown
+    unsigned char rings[] CACHE_ALIGNED;
+} ChannelSet;
+
+size_t channel_set_size(int count, uint32_t capacity, uint32_t msg_size);
+
+// Map the named segment; the launcher creates it with init set before any
+// process or thread uses it, the others map what it laid out
+ChannelSet *channel_set_open(const char *name, int count, uint32_t capacity, uint32_t msg_size, int init);
+void channel_set_unmap(ChannelSet *set);
+
+// Wake every blocked sender and receiver; all calls fail from now on
+void channel_set_shutdown(ChannelSet *set);
+
+// Blocks while the channel is full. -1 once the set is shut down.
+int channel_send(ChannelSet *set, int channel, const void *msg);
+
+// Blocks while the channel is empty. -1 once the set is shut down.
+int channel_recv(ChannelSet *set, int channel, void *msg);
+
+// Never blocks; -1 when the channel is empty
+int channel_try_recv(ChannelSet *set, int channel, void *msg);
+
+// Receivers asleep on the empty channel (a snapshot, may be stale at once)
+uint32_t channel_waiting_receivers(ChannelSet *set, int channel);
+
+// Blocks at most timeout (real time, not coroutine-aware); -1 on timeout
+int channel_recv_timeout(ChannelSet *set, int channel, void *msg, const struct timespec *timeout);
+
+#endif // CHANNEL_H
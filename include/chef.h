@@ -10,7 +10,10 @@
 #include "products.h"
 #include "game.h"
 #include "team.h"
+#include "random.h"
+#include "channel.h"
 
+struct ChefBatch;   // bakery_message.h
 
 
 
@@ -22,8 +25,6 @@ typedef struct {
     int is_waiting_for_ingredients;
     IngredientType waiting_for;
     int waiting_quantity;
-    sem_t* inventory_sem;
-    sem_t* ready_products_sem;
 } ChefState;
 
 
@@ -38,11 +39,7 @@ typedef struct {
 
 typedef struct {
     int chef_count;
-    int msg_queue_chefs;    // Queue for communication with chefs
-    int msg_queue_bakers;   // Queue for communication with baker manager
-    ProductCatalog* product_catalog;
-    sem_t* inventory_sem;
-    sem_t* ready_products_sem;
+    ChannelSet *channels;   // Bake channels: chefs in, baker dispatcher out
 } ChefManager;
 
 
@@ -51,12 +48,16 @@ typedef struct {
 void check_and_request_ingredients(ChefState *chef, Inventory *inventory);
 void check_for_confirmations(ChefState *chef);
 void prepare_recipes(ChefState *chef, Inventory *inventory, ReadyProducts *ready_products);
-ChefManager* init_chef_manager(ProductCatalog* catalog, sem_t* inv_sem, sem_t* ready_sem);
+ChefManager* init_chef_manager(ChannelSet *channels);
 void start_chef(Chef* chef, int msg_queue_id);
-void process_chef_messages(ChefManager* manager, int msg_queue, int baker_msg_queue, struct Game *game);
+void process_chef_messages(ChefManager* manager, struct Game *game, const struct ChefBatch *first);
 ChefTeam get_team_for_product_type(ProductType type);
 ProductType get_product_type_for_team(ChefTeam team);
-void simulate_chef_work(ChefTeam team, int msg_queue_id, struct Game *game, int id);
+void simulate_chef_work(ChefTeam team, ChannelSet *channels, struct Game *game, int id);
+void run_chef_worker(ChefTeam team, ChannelSet *channels, struct Game *game, int id);
+void run_chef_manager(ChefManager *manager, struct Game *game);
+void distribute_chefs(int num_chefs, int chefs_per_team[TEAM_COUNT], RandomStream *rng);
+int take_recipe_ingredients(Inventory *inventory, const Product *product);
 void calculate_production_ratios(const ReadyProducts *ready_products, float *ratios);
 void reallocate_chefs(ChefManager* manager, int msg_queue, float* ratios);
 void balance_teams(struct Game *game);
@@ -44,10 +44,16 @@ typedef struct {
     float PRODUCTION_RATIO_THRESHOLD;
     int MIN_CHEFS_PER_TEAM;
     int INGREDIENTS_TO_ORDER;
+    float TIME_SCALE;  // Simulated seconds per real second (optional, defaults to 1)
+    unsigned int SEED; // Master seed for every random stream (optional, 0 picks one)
+    int SELLER_WINDOW; // Customers one seller serves at once (optional, defaults to 1)
+    float PRODUCT_WAIT; // Seconds an order may wait for ready products (optional, defaults to 0)
 } Config;
 
 int load_config(const char *filename, Config *config);
+int set_config_value(Config *config, const char *key, double value);
 int load_product_catalog(const char *filename, ProductCatalog *catalog);
+void free_product_catalog(ProductCatalog *catalog);
 void print_config(Config *config);
 int check_parameter_correctness(const Config *config);
 void serialize_config(Config *config, char *buffer);
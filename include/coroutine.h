@@ -0,0 +1,65 @@
+//
+// Stackful coroutines (ucontext) for the actor loops.
+//
+// A CoroScheduler runs many coroutines on the OS thread that calls
+// coro_scheduler_run. While a coroutine runs, sim_sleep parks it until its
+// wake-up time instead of blocking the thread, and coro_msgrcv /
+// coro_futex_wait poll and yield instead of blocking. Outside a coroutine
+// all three behave exactly like the blocking calls, so the same loop runs
+// as a process, a thread or a coroutine.
+//
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <ucontext.h>
+#include "event_queue.h"
+#include "sim_clock.h"
+
+#define CORO_STACK_SIZE (64 * 1024)
+#define CORO_POLL_INTERVAL 0.05   // Simulated seconds between two polls of a blocking call
+
+typedef void (*coro_fn)(void *arg);
+
+typedef struct {
+    ucontext_t context;
+    coro_fn fn;
+    void *arg;
+    void *stack;
+    int done;
+} Coroutine;
+
+typedef struct {
+    const SimClock *clock;
+    ucontext_t context;        // Scheduler loop, resumed whenever a coroutine parks
+    Coroutine *coroutines;
+    int count;
+    int capacity;
+    int live;
+    int current;               // Index of the running coroutine or -1
+    EventQueue runnable;       // Parked coroutines ordered by wake-up time
+} CoroScheduler;
+
+int coro_scheduler_init(CoroScheduler *scheduler, const SimClock *clock, int capacity);
+void coro_scheduler_destroy(CoroScheduler *scheduler);
+
+// Add a coroutine; it first runs once coro_scheduler_run is called
+int coro_spawn(CoroScheduler *scheduler, coro_fn fn, void *arg);
+
+// Run the coroutines on the calling thread until every one has returned
+void coro_scheduler_run(CoroScheduler *scheduler);
+
+// True when called from inside a coroutine
+int coro_active(void);
+
+// Let the other runnable coroutines go first
+void coro_yield(void);
+
+// Blocking calls with a yield point
+ssize_t coro_msgrcv(int msqid, void *msgp, size_t msgsz, long msgtyp, int msgflg);
+int coro_futex_wait(uint32_t *addr, uint32_t expected);
+
+#endif // COROUTINE_H
@@ -3,7 +3,6 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
-#include "queue.h"
 
 #define MAX_NAME_LEN 32
 
@@ -14,6 +13,7 @@
 
 #include "config.h"
 #include "game.h"
+#include "random.h"
 // Customer states
 typedef enum {
     WALKING,
@@ -28,20 +28,19 @@ typedef enum {
 
 typedef struct {
     int id;
-    pid_t pid;
+    pid_t pid;             // Customer key (id + 1), the mtype of its messages
     float patience;  // in seconds
     float patience_decay;  // in seconds
     bool has_complained;
-    short seller_id;
+    short seller_id;       // Lane of the customer line it queues in
     CustomerState state;
 } Customer;
 
 
-void create_random_customer(Customer *customer, Config *config);
+void create_random_customer(Customer *customer, Config *config, RandomStream *rng);
 void deserialize_customer(Customer *customer, char *buffer);
 void serialize_customer(Customer *customer, char *buffer);
 void free_customer(Customer *customer);
 void print_customer(Customer *customer);
-void generate_random_customer_order(CustomerOrder *order, Game *game);
-void cleanup_queue_shared_memory(queue_shm *queue_shm, size_t capacity);
+void generate_random_customer_order(CustomerOrder *order, Game *game, RandomStream *rng);
 #endif // CUSTOMER_H
\ No newline at end of file
@@ -0,0 +1,91 @@
+//
+// The customer line, shared by the customer manager, the sellers and the
+// graphics process through the customer queue segment.
+//
+// The line is a fixed slab of slots, one per customer that can be waiting,
+// direct-mapped by key: (key - 1) % capacity, the same mapping as the
+// manager's actors. The key also carries the slot's generation, so it is the
+// customer's handle: a slot whose customer.pid no longer matches a key has
+// moved on to someone else.
+//
+// The slab is sharded into one lane per seller. Each lane threads its
+// waiting slots into an intrusive doubly-linked FIFO, so joining, taking the
+// front customer and removing one from the middle of the line are all O(1).
+// The links are changed under the lane's mutex and published through the
+// lane's seqlock, so graphics walks a lane without locking it. A seller with
+// nothing in its lane steals the front of the others before it sleeps on
+// its lane's futex. Only the manager writes the customers in the slots,
+// through their seqlocks.
+//
+// A customer keeps their slot after a seller takes them, until they leave
+// the bakery. The slot is where their status lives (state and patience,
+// written in place) and where the order is handed to the seller: the
+// manager posts its ref into the slot with one atomic store and the seller
+// picks it up, so only the lifecycle notices (called, order done) go
+// through a message queue.
+//
+
+#ifndef CUSTOMER_LINE_H
+#define CUSTOMER_LINE_H
+
+#include <stddef.h>
+#include <time.h>
+#include "customer.h"
+#include "seqlock.h"
+#include "shm_arena.h"
+
+typedef struct {
+    SeqLock seq;
+    Customer customer;          // customer.pid is 0 while the slot is free
+    int prev, next;             // Lane links while queued, -1 at either end
+    int queued;                 // Linked into its lane, no seller took it yet
+    int counted;                // In its lane's waiting count, not called yet
+    uint64_t order;             // key << 32 | ref posted for the seller, 0 if none
+} LineSlot;
+
+typedef struct {
+    int capacity;               // Slots, MAX_CUSTOMERS; the lanes follow them
+    int lane_count;             // One per seller, NUM_SELLERS
+    LineSlot slots[];
+} CustomerLine;
+
+size_t customer_line_size(int capacity, int lanes);
+
+// Map the customer queue segment, sized from MAX_CUSTOMERS and NUM_SELLERS.
+// The customer manager creates it with init set; every other process maps
+// what the manager laid out.
+CustomerLine *customer_line_open(const Config *config, int init);
+void customer_line_close(CustomerLine *line, const Config *config);
+
+// Manager side. The customer queues in lane (its seller_id is set to it).
+// Called: the seller's call reached the customer, who no longer waits.
+// Leaving frees the slot, unlinking the customer wherever they stand in
+// their lane if no seller took them yet.
+int customer_line_join(CustomerLine *line, const Customer *customer, int lane);
+int customer_line_update(CustomerLine *line, pid_t key, CustomerState state, float patience);
+int customer_line_called(CustomerLine *line, pid_t key);
+int customer_line_leave(CustomerLine *line, pid_t key);
+int customer_line_post_order(CustomerLine *line, pid_t key, ShmRef order);
+
+// Customers waiting in lane, including one its seller is calling right now
+int customer_line_waiting(const CustomerLine *line, int lane);
+
+// Seller side: next customer still waiting in lane, or in another lane if
+// lane is empty; -1 if none came within timeout
+int customer_line_next(CustomerLine *line, int lane, Customer *customer, const struct timespec *timeout);
+
+// Seller side: 1 with the posted order in *order (now the seller's to
+// free), 0 while the customer is still choosing, -1 once they left
+int customer_line_take_order(CustomerLine *line, pid_t key, ShmRef *order);
+
+// Seller side: nonzero while the customer with this key has not left
+int customer_line_present(CustomerLine *line, pid_t key);
+
+// Copies of the customers queued in lane, front first, at most max of them.
+// A consistent state of the lane; never blocks the manager or the sellers.
+int customer_line_lane_snapshot(const CustomerLine *line, int lane, Customer *customers, int max);
+
+// Copies of the customers queued in every lane in arrival order, at most max
+int customer_line_snapshot(const CustomerLine *line, Customer *customers, int max);
+
+#endif // CUSTOMER_LINE_H
@@ -0,0 +1,76 @@
+#ifndef CUSTOMER_MANAGER_H
+#define CUSTOMER_MANAGER_H
+
+#include <semaphore.h>
+#include <stdbool.h>
+#include "game.h"
+#include "customer.h"
+#include "customer_line.h"
+#include "bakery_message.h"
+#include "event_queue.h"
+
+#define CUSTOMER_TICK 1.0      // Simulated seconds between two steps of a customer
+
+// Scheduler events of a customer actor
+typedef enum {
+    CUSTOMER_EV_TICK,          // Patience decay and handle_state, once per CUSTOMER_TICK
+    CUSTOMER_EV_REACHED_QUEUE, // Done walking
+    CUSTOMER_EV_ORDER_READY    // Done choosing, the order goes to the seller
+} CustomerEvent;
+
+// One customer, living inside the customer manager
+typedef struct {
+    Customer customer;         // customer.pid is the key sellers address it by
+    float original_patience;
+    bool active;
+    bool in_queue;             // Still in the customer line (not called by a seller yet)
+    bool ticking;              // Patience decays until a seller calls the customer
+    bool busy;                 // A timed action (walking, ordering) is pending
+    int generation;            // Bumped when the slot is freed, drops stale events
+    RandomStream rng;          // Seeded from SEED and the customer id
+} CustomerActor;
+
+// Everything the customer manager loop needs, so it can run as its own
+// process or as a thread of the multithreaded runtime
+typedef struct {
+    Game *game;
+    CustomerLine *customer_line;
+    ShmArena *arena;           // Orders are written here and sent by ref
+    sem_t *complaint_sem;
+    int inbox_queue_id;        // SellerMessage from the sellers
+    int active_customers;
+    int next_customer_id;
+
+    CustomerActor *actors;     // Direct-mapped by key: slot = (key - 1) % capacity
+    int capacity;
+    int *free_slots;           // Stack of inactive actor slots
+    int free_count;
+    EventQueue events;
+    double now;                // Simulated time of the event being handled
+    double next_arrival;
+    RandomStream rng;          // Arrivals; each customer draws from its own stream
+} CustomerManager;
+
+int init_customer_manager(CustomerManager *manager, Game *game);
+void cleanup_customer_manager(CustomerManager *manager);
+
+// Run everything due by the simulated time now: arrivals, seller messages
+// and customer events. Returns the time of the next scheduled event.
+double customer_manager_step(CustomerManager *manager, double now);
+
+// Runs customer_manager_step until the game is over
+void run_customer_manager(CustomerManager *manager);
+
+void spawn_customer(CustomerManager *manager);
+void process_seller_messages(CustomerManager *manager);
+void check_and_reset_complaints(CustomerManager *manager);
+void handle_customer_state(CustomerManager *manager, CustomerState state, pid_t key);
+
+// Customer actor state machine (customer_actor.c)
+void handle_state(CustomerManager *manager, CustomerActor *actor);
+void customer_tick(CustomerManager *manager, CustomerActor *actor);
+void customer_event(CustomerManager *manager, CustomerActor *actor, CustomerEvent event);
+void customer_seller_message(CustomerManager *manager, CustomerActor *actor, const SellerMessage *msg);
+void leave_restaurant(CustomerManager *manager, CustomerActor *actor, CustomerState final_state, ActionType action);
+
+#endif // CUSTOMER_MANAGER_H
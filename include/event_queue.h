@@ -0,0 +1,36 @@
+//
+// Priority-queue event calendar for the discrete-event simulation.
+//
+
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <stddef.h>
+
+// A scheduled event. Events fire in order of time; events scheduled for the
+// same instant fire in the order they were pushed (seq breaks the tie).
+typedef struct {
+    double time;            // Simulated time (seconds) the event fires at
+    unsigned long seq;      // Insertion counter, keeps ordering deterministic
+    int type;               // Caller-defined event kind
+    int actor;              // Index of the actor the event belongs to
+    int data;               // Extra payload (e.g. generation of the actor slot)
+} SimEvent;
+
+// Binary min-heap of events ordered by (time, seq)
+typedef struct {
+    SimEvent *events;
+    size_t count;
+    size_t capacity;
+    unsigned long next_seq;
+} EventQueue;
+
+int event_queue_init(EventQueue *queue, size_t initial_capacity);
+void event_queue_destroy(EventQueue *queue);
+int event_queue_push(EventQueue *queue, double time, int type, int actor, int data);
+int event_queue_pop(EventQueue *queue, SimEvent *event);
+int event_queue_peek(const EventQueue *queue, SimEvent *event);
+int event_queue_is_empty(const EventQueue *queue);
+size_t event_queue_size(const EventQueue *queue);
+
+#endif // EVENT_QUEUE_H
@@ -0,0 +1,20 @@
+//
+// Thin wrappers around the futex syscall for words living in shared memory.
+//
+
+#ifndef FUTEX_UTILS_H
+#define FUTEX_UTILS_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Sleep while *addr == expected. Returns early on wake, signal or value change.
+int futex_wait(uint32_t *addr, uint32_t expected);
+
+// futex_wait bounded by a relative timeout. Returns 1 once the timeout expired.
+int futex_wait_timeout(uint32_t *addr, uint32_t expected, const struct timespec *timeout);
+
+// Wake up to count waiters blocked on addr
+int futex_wake(uint32_t *addr, int count);
+
+#endif // FUTEX_UTILS_H
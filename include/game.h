@@ -8,39 +8,131 @@
 #include "inventory.h"
 #include "oven.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include "info.h"
+#include "sim_clock.h"
+#include "timer_wheel.h"
+#include "game_stats.h"
+#include "cache_line.h"
 
-#define MAX_OVENS 10  // Max ovens allowed
+#define GAME_LAYOUT_MAGIC 0x42414b45u   // "BAKE"
+#define GAME_LAYOUT_VERSION 3
 
+// Where a catalog category's products sit in the product arrays
+typedef struct {
+    ProductType type;       // Type from the catalog file
+    int first;              // Index of its first product
+    int product_count;
+} GameCategory;
+
+// Segment header. The per-actor slots and the products are not part of the
+// struct: they follow it in arrays sized from the config and the catalog
+// when the segment is created, each starting on its own cache line.
+// Processes attaching to the segment take its size and the array offsets
+// from here.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    size_t size;            // Bytes of the whole segment
+    int chef_slots;
+    int baker_slots;
+    int seller_slots;
+    int oven_slots;
+    int product_slots;      // Products over all categories
+    int category_count;
+    GameCategory categories[NUM_PRODUCTS];
+    size_t chefs;           // Array offsets from the start of the Game
+    size_t bakers;
+    size_t sellers;
+    size_t ovens;
+    size_t oven_timers;     // TimerEntry of each oven, see oven_timers
+    size_t products;        // Product recipes, read-only once laid out
+    size_t ready;           // Ready count of each product, see ReadyProducts
+} GameLayout;
+
+// Regions written by different processes start on their own cache line,
+// so a write in one never invalidates the line another process is reading
 typedef struct Game {
 
-    pid_t complaining_customer_pid;
+    /* --- read-mostly, set up by main before the workers start --- */
+    GameLayout layout;
+    Config config;
+    SimClock clock;        // Simulated clock, started by main
+
+    /* --- written by main's clock thread --- */
+    int elapsed_time CACHE_ALIGNED;
+    uint32_t game_over;    // Futex word, set to 1 once an end condition is met
+
+    /* --- written by the customer manager --- */
+    pid_t complaining_customer_pid CACHE_ALIGNED;
     int last_complaint_time;
-    int elapsed_time;
-    int num_frustrated_customers;
-    int num_complained_customers;
-    int num_customers_missing;
-    int num_customers_served;
-    int num_customers_cascade;
-    float daily_profit;
     bool recent_complaint;
 
-    Config config;
-    Inventory inventory;
-    ProductCatalog productCatalog;
-    ReadyProducts ready_products;
+    /* --- shared hot data, one region each --- */
+    Inventory inventory CACHE_ALIGNED;
+    ReadyProducts ready_products CACHE_ALIGNED;
+    TimerWheel oven_timers CACHE_ALIGNED; // Bake completions, timer id = oven index, one per oven slot
 
     Info info;
+    GameStats stats;        // Served, frustrated, ..., daily profit
 
-    Oven ovens[MAX_OVENS]; // Shared ovens
+    /* --- per-actor slots and products follow, see GameLayout --- */
 } Game;
 
+// Per-actor slots; ids run from 0 to the matching layout slot count
+static inline Chef *game_chef(const Game *game, int id) {
+    return (Chef *) ((char *) game + game->layout.chefs) + id;
+}
+
+static inline Baker *game_baker(const Game *game, int id) {
+    return (Baker *) ((char *) game + game->layout.bakers) + id;
+}
+
+static inline Seller *game_seller(const Game *game, int id) {
+    return (Seller *) ((char *) game + game->layout.sellers) + id;
+}
+
+static inline Oven *game_oven(const Game *game, int id) {
+    return (Oven *) ((char *) game + game->layout.ovens) + id;
+}
+
+// Catalog categories run from 0 to layout.category_count, their products
+// from 0 to game_product_count()
+static inline int game_product_count(const Game *game, int category) {
+    return game->layout.categories[category].product_count;
+}
+
+static inline Product *game_product(const Game *game, int category, int index) {
+    return (Product *) ((char *) game + game->layout.products) + game->layout.categories[category].first + index;
+}
+
+// Ready counts of the products, product_slots of them
+static inline int *game_ready_quantities(const Game *game) {
+    return (int *) ((char *) game + game->layout.ready);
+}
+
+// Bytes of a Game laid out for config and catalog; catalog may be NULL for
+// a game without products
+size_t game_size(const Config *config, const ProductCatalog *catalog);
+// Copy config and the catalog products in and write the header; memory must
+// span game_size(config, catalog)
+void game_layout(Game *game, const Config *config, const ProductCatalog *catalog);
+// Nonzero if the header is one this build can read
+int game_layout_valid(const Game *game);
+
 // Still can keep these (but optional now)
 pid_t start_process(const char *binary, int shared_mem_fd, bool suppress);
+int game_reset(Game *game);
+// Zero ready counts for every catalog product, see ReadyProducts
+int game_reset_ready_products(Game *game);
+Game *game_alloc(const Config *config, const ProductCatalog *catalog);
 int game_init(Game *game, pid_t *processes, pid_t *processes_sellers, int shared_mem_fd);
 void game_destroy(int shm_fd, Game *shared_game);
 void game_create(int *shm_fd, Game **shared_game);
 int check_game_conditions(const Game *game);
+void notify_game_state(Game *game);
+void wait_for_game_over(Game *game);
+void *run_game_clock(void *arg);
 void print_with_time1(const Game *game, const char *format, ...);
 
 #endif // GAME_H
@@ -0,0 +1,48 @@
+//
+// Sharded KPI counters living in the Game segment.
+//
+// Every writer (process or thread) owns one cache-line-sized shard and adds
+// to it with relaxed atomics, so sellers and customer managers never bounce
+// a shared line between cores. Readers sum the shards; the total is exact
+// once the writers are done and never torn while they run.
+//
+
+#ifndef GAME_STATS_H
+#define GAME_STATS_H
+
+#include <stdint.h>
+#include "cache_line.h"
+
+#define MAX_STAT_SHARDS 64    // Writers beyond this share shards, still exact
+#define STATS_PROFIT_SCALE 100  // Profit is counted in cents
+
+typedef enum {
+    STAT_SERVED,
+    STAT_FRUSTRATED,
+    STAT_COMPLAINED,
+    STAT_MISSING,
+    STAT_CASCADE,
+    STAT_PROFIT,        // In 1/STATS_PROFIT_SCALE units, read with stats_profit
+    NUM_STATS
+} StatCounter;
+
+typedef struct {
+    int64_t values[NUM_STATS];
+} CACHE_ALIGNED StatShard;
+
+typedef struct {
+    StatShard shards[MAX_STAT_SHARDS];
+    int next_shard;     // Next shard handed to a new writer
+} GameStats;
+
+void stats_reset(GameStats *stats);
+
+// Add to the calling thread's shard (claimed on its first write)
+void stats_add(GameStats *stats, StatCounter counter, int64_t amount);
+void stats_add_profit(GameStats *stats, float amount);
+
+// Sum over all shards
+int64_t stats_read(const GameStats *stats, StatCounter counter);
+float stats_profit(const GameStats *stats);
+
+#endif // GAME_STATS_H
@@ -4,14 +4,10 @@
 #include "team.h"
 #include "seller.h"
 
-#define MAX_MEMBERS 20
-
+// The chef, baker and seller slots themselves follow the fixed part of
+// Game, sized from the config; see GameLayout and game_chef() in game.h
 typedef struct {
-    Chef chefs[MAX_MEMBERS];
-    Baker bakers[MAX_MEMBERS];
-    Seller sellers[MAX_MEMBERS];
-
-    int chef_count;
+    int chef_count CACHE_ALIGNED;
 } Info;
 
 
@@ -11,51 +11,78 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
-#include <semaphore.h>
+#include <pthread.h>
 #include <errno.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
 #include "products.h"
+#include "seqlock.h"
 
+// Ingredient stock is fixed point: INVENTORY_SCALE steps per unit
+#define INVENTORY_SCALE 1000
 
 
-
-// Inventory struct with array-based approach
+// Lock-free inventory: stock and paste_count are only touched with atomics,
+// so chefs and supply chains never wait on each other
 typedef struct {
-    float quantities[NUM_INGREDIENTS];  // Array of ingredient quantities
+    int64_t stock[NUM_INGREDIENTS];  // Fixed-point quantity of each ingredient
     int paste_count;
     int max_capacity;
 } Inventory;
 
-// In inventory.h
+// A category's products are a run of the quantities array
 typedef struct {
-    int quantities[MAX_PRODUCTS_PER_CATEGORY];  // Quantities for specific products within category
-    int product_count;                          // Number of product types in this category
+    int first;                  // Index of the category's first product in the quantities
+    int product_count;          // Number of product types in this category
 } ReadyProductCategory;
 
 typedef struct {
+    pthread_mutex_t lock;                          // Robust and process-shared, serialises writers
+    SeqLock seq;                                   // Lets readers copy the counts without the lock
     ReadyProductCategory categories[NUM_PRODUCTS];  // Array indexed by ProductType enum
     int total_count;                               // Total number of products ready
     int max_capacity;                              // Maximum storage capacity
+    int product_slots;                             // Length of the quantities array
+    ptrdiff_t quantities;                          // Where the per-product counts are, in bytes from this struct
 } ReadyProducts;
 
+// The per-product counts live outside the struct, sized from the catalog.
+// A relative offset finds them at whatever address a process maps them.
+static inline int *ready_quantities(const ReadyProducts *ready_products) {
+    return (int *) ((char *) ready_products + ready_products->quantities);
+}
+
 // Function prototypes for inventory operations
 void init_inventory(Inventory *inventory);
-void add_ingredient(Inventory *inventory, IngredientType type, float quantity, sem_t* sem);
-void add_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS], sem_t* sem);
-int check_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS], sem_t* sem);
-void use_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS], sem_t* sem);
-void restock_ingredients(Inventory *inventory, sem_t* sem);
+float get_ingredient(const Inventory *inventory, IngredientType type);
+// Adds up to max_capacity and returns the new quantity
+float add_ingredient(Inventory *inventory, IngredientType type, float quantity);
+void add_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS]);
+int check_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS]);
+void use_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS]);
+void restock_ingredients(Inventory *inventory);
 void print_inventory(Inventory *inventory);
-void add_paste(Inventory *inventory, int quantity, sem_t* sem);
-int get_paste_count(Inventory *inventory, sem_t* sem);
+void add_paste(Inventory *inventory, int quantity);
+int get_paste_count(Inventory *inventory);
+
+// Take the ingredients of a recipe one by one, putting back what was taken
+// if one runs short. Returns 1 if all were taken, 0 otherwise. A partial take
+// is visible to others until it is put back, so a competing reservation can
+// fail spuriously.
+int reserve_ingredients(Inventory *inventory, const Ingredient *ingredients, int count);
 
 
 
-int check_and_fulfill_order(ReadyProducts *ready_products, CustomerOrder *order, sem_t* sem);
+int check_and_fulfill_order(ReadyProducts *ready_products, CustomerOrder *order);
 
-void init_ready_products(ReadyProducts *ready_products);
-void add_ready_product(ReadyProducts *ready_products, ProductType type, int product_index, int quantity, sem_t* sem);
-int get_ready_product(ReadyProducts *ready_products, ProductType type, int product_index, int quantity, sem_t* sem);
+// quantities holds one count per product, product_counts[i] of them for
+// category i, and must stay mapped wherever ready_products is
+int init_ready_products(ReadyProducts *ready_products, int *quantities, const int product_counts[NUM_PRODUCTS]);
+// Consistent copy of the product_slots counts for readers
+void snapshot_ready_products(const ReadyProducts *ready_products, int *quantities);
+void add_ready_product(ReadyProducts *ready_products, ProductType type, int product_index, int quantity);
+int get_ready_product(ReadyProducts *ready_products, ProductType type, int product_index, int quantity);
 
 
 #endif //INVENTORY_H
\ No newline at end of file
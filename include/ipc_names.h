@@ -0,0 +1,46 @@
+//
+// Per-run names for every named IPC resource.
+//
+// Shared memory names, semaphore names and message queue keys all carry a
+// run instance ID, so several simulations can run side by side on one host.
+// The launcher (main, bakery_mt) picks the instance with ipc_init_instance;
+// it travels to every child through the BAKERY_INSTANCE environment
+// variable, which fork and exec keep.
+//
+
+#ifndef IPC_NAMES_H
+#define IPC_NAMES_H
+
+#include <sys/types.h>
+
+#define INSTANCE_ENV "BAKERY_INSTANCE"
+
+typedef enum {
+    IPC_GAME_SHM,
+    IPC_CUSTOMER_QUEUE_SHM,
+    IPC_BAKE_CHANNEL_SHM,
+    IPC_ARENA_SHM,
+    IPC_COMPLAINT_SEM,
+    IPC_OVEN_SEM,          // Prefix, oven.c appends the oven index
+    IPC_NAME_COUNT
+} IpcName;
+
+typedef enum {
+    IPC_CUSTOMER_INBOX_KEY,
+    IPC_SUPPLY_CHAIN_KEY,
+    IPC_KEY_COUNT
+} IpcKey;
+
+// Launchers only: keep an exported BAKERY_INSTANCE, else use our pid, and
+// export it for the children. Call before any resource is opened.
+void ipc_init_instance(void);
+void ipc_set_instance(unsigned int instance);
+unsigned int ipc_instance(void);
+
+// "/name_<instance>"; the string lives until exit
+const char *ipc_name(IpcName name);
+
+// Distinct for every (instance mod 2^22, key) pair
+key_t ipc_key(IpcKey key);
+
+#endif // IPC_NAMES_H
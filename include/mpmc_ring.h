@@ -0,0 +1,57 @@
+//
+// Bounded lock-free multi-producer multi-consumer ring for shared memory.
+//
+// Every cell carries a sequence number (Vyukov's bounded queue): a producer
+// claims a position with a CAS on enqueue_pos once the cell's sequence says
+// it is free, copies the element in and publishes it by bumping the
+// sequence; consumers do the same on dequeue_pos. No locks are held, so a
+// process dying mid-operation can at worst leave its own cell unpublished.
+//
+// Consumers that find the ring empty can block on the items futex word,
+// which every push bumps, and are woken as soon as an element arrives.
+// Producers facing a full ring can block the same way on slots, which
+// every pop bumps.
+//
+
+#ifndef MPMC_RING_H
+#define MPMC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "cache_line.h"
+
+typedef struct {
+    uint32_t capacity;                // Power of two
+    uint32_t mask;
+    uint32_t elem_size;
+    uint32_t cell_size;               // Sequence word plus element, 8-byte aligned
+    uint32_t enqueue_pos CACHE_ALIGNED;
+    uint32_t dequeue_pos CACHE_ALIGNED;
+    uint32_t items CACHE_ALIGNED;     // Futex word, bumped by every push
+    uint32_t waiters;                 // Consumers blocked on items
+    uint32_t slots CACHE_ALIGNED;     // Futex word, bumped by every pop
+    uint32_t slot_waiters;            // Producers blocked on slots
+    unsigned char cells[] CACHE_ALIGNED;
+} MpmcRing;
+
+// Smallest power of two holding at least count elements
+uint32_t mpmc_ring_capacity(uint32_t count);
+
+// Bytes a ring of capacity elements of elem_size takes (capacity a power of two)
+size_t mpmc_ring_size(uint32_t elem_size, uint32_t capacity);
+
+int mpmc_ring_init(MpmcRing *ring, uint32_t elem_size, uint32_t capacity);
+
+// Non-blocking; both return -1 when the ring is full or empty
+int mpmc_ring_push(MpmcRing *ring, const void *elem);
+int mpmc_ring_pop(MpmcRing *ring, void *elem);
+
+// Pop, sleeping on the futex while the ring is empty. Returns -1 once the
+// relative timeout passed without an element.
+int mpmc_ring_pop_wait(MpmcRing *ring, void *elem, const struct timespec *timeout);
+
+// Elements pushed and not yet popped (a snapshot, may be stale at once)
+uint32_t mpmc_ring_count(const MpmcRing *ring);
+
+#endif // MPMC_RING_H
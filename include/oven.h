@@ -2,20 +2,22 @@
 #define OVEN_H
 
 #include <semaphore.h>
-
-#define MAX_OVENS 10  // adjust as needed
+#include "cache_line.h"
+#include "seqlock.h"
 
 typedef struct {
+    SeqLock seq;            // Bumped around every update, see seqlock.h
     int id;
     int is_busy;
-    int time_left;
+    int time_left;          // Bake time when the item went in
+    double ready_at;        // Simulated time the bake completes
     char item_name[50];
     char team_name[50];
-} Oven;
+} CACHE_ALIGNED Oven;
 
 // Oven control functions
 void init_oven(Oven *oven, int id);
-int put_item_in_oven(Oven *oven, const char *item_name, const char *team_name, int baking_time);
+int put_item_in_oven(Oven *oven, const char *item_name, const char *team_name, int baking_time, double ready_at);
 int oven_tick(Oven *oven);
 
 // Semaphore-based synchronization
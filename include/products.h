@@ -8,7 +8,6 @@
 #define MAX_ORDER_ITEMS_ 5
 #define MAX_NAME_LENGTH 25
 #define MAX_INGREDIENTS 10
-#define MAX_PRODUCTS_PER_CATEGORY 20
 #define MAX_CATEGORIES 10
 
 
@@ -66,11 +65,12 @@ typedef struct {
 // Category struct to hold products of the same type
 typedef struct {
     ProductType type; // Type of product (e.g., bread, cake, etc.)
-    Product products[MAX_PRODUCTS_PER_CATEGORY];
+    Product *products; // Heap array of product_count products
     int product_count;
 } ProductCategory;
 
-// ProductCatalog to hold all categories
+// ProductCatalog to hold all categories, as loaded from the JSON file.
+// The game segment keeps its own copy, see game_product().
 typedef struct {
     ProductCategory categories[NUM_PRODUCTS];
     int category_count;
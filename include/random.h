@@ -1,12 +1,46 @@
 //
 // Created by - on 3/23/2025.
 //
+// Seeded xoshiro256** streams. Every actor owns one RandomStream derived
+// from the master SEED and its (role, id), so runs are reproducible and
+// threads never share generator state.
+//
 
 #ifndef RANDOM_H
 #define RANDOM_H
 
+#include <stdint.h>
+
+typedef struct {
+    uint64_t s[4];
+} RandomStream;
+
+typedef enum {
+    RANDOM_MAIN,
+    RANDOM_CHEF_MANAGER,
+    RANDOM_CHEF,
+    RANDOM_BAKER_MANAGER,
+    RANDOM_BAKER,
+    RANDOM_SUPPLY_MANAGER,
+    RANDOM_SUPPLY_CHAIN,
+    RANDOM_SELLER,
+    RANDOM_CUSTOMER_MANAGER,
+    RANDOM_CUSTOMER,
+    RANDOM_SIMULATION
+} RandomRole;
+
+// SEED 0 means "pick one": time and pid, as before streams existed
+unsigned int resolve_seed(unsigned int seed);
+
+void random_stream_init(RandomStream *stream, uint64_t seed, RandomRole role, int id);
+uint64_t random_next(RandomStream *stream);
+
+uint32_t random_below(RandomStream *stream, uint32_t bound);   // [0, bound)
+int random_int(RandomStream *stream, int min, int max);        // [min, max]
+float random_float(RandomStream *stream, float min, float max); // [min, max)
 
-void init_random();
-float random_float(float min, float max);
+// Bulk draws for hot paths that need many variates at once
+void random_fill_below(RandomStream *stream, uint32_t *out, int n, uint32_t bound);
+void random_fill_float(RandomStream *stream, float *out, int n, float min, float max);
 
 #endif //RANDOM_H
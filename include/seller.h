@@ -1,6 +1,9 @@
 #ifndef SELLER_H
 #define SELLER_H
 
+#include <sys/types.h>
+#include "cache_line.h"
+
 typedef enum SellerState {
     IDLE,
     TAKING_ORDER,
@@ -13,11 +16,11 @@ typedef struct {
     int id;
     pid_t pid;
     SellerState state;
-} Seller;
+    int serving;          // Customers in the seller's window
+} CACHE_ALIGNED Seller;   // Written by its own seller only
 
 
 int send_completion_message(int msg_queue_id, pid_t customer_pid, float total_price, const char* status);
-int get_message_queue();
 const char* get_seller_state_string(SellerState state);
 void init_seller(Seller *seller, int id);
 
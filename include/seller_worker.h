@@ -0,0 +1,23 @@
+#ifndef SELLER_WORKER_H
+#define SELLER_WORKER_H
+
+#include "seller.h"
+#include "game.h"
+#include "customer.h"
+#include "customer_line.h"
+#include "shm_arena.h"
+
+// What one seller loop works with, whether it runs as a process or a thread
+typedef struct {
+    Seller *seller;
+    Game *game;
+    CustomerLine *customer_line;
+    ShmArena *arena;           // Where the customers' orders live
+    int customer_inbox_id;     // SellerMessage to the customers
+    volatile int *running;     // Loop stops once this drops to 0
+} SellerContext;
+
+// Serves up to SELLER_WINDOW customers at once, each in its own phase
+void seller_loop(SellerContext *ctx);
+
+#endif // SELLER_WORKER_H
@@ -1,24 +1,22 @@
 #ifndef SEMAPHORES_UTILS_H
 #define SEMAPHORES_UTILS_H
+#include <pthread.h>
 #include <semaphore.h>
+#include "ipc_names.h"
 
-#define SEM_NAME "/bakery_inventory_sem"
-#define READY_SEM_NAME "/bakery_ready_products_sem"
-#define COMPLAINT_SEM_NAME "/bakery_complaint_sem"
-#define QUEUE_SEM_NAME "/customer_queue_sem"
+#define COMPLAINT_SEM_NAME ipc_name(IPC_COMPLAINT_SEM)
 
 
-sem_t* setup_inventory_semaphore();
-void lock_inventory(sem_t* sem);
-void unlock_inventory(sem_t* sem);
-void cleanup_inventory_semaphore_resources(sem_t* inventory_sem);
-// Function prototypes for ready products
-sem_t* setup_ready_products_semaphore(void);
-void lock_ready_products(sem_t* sem);
-void unlock_ready_products(sem_t* sem);
-void cleanup_ready_products_semaphore_resources(sem_t* ready_products_sem);
+// Process-shared robust mutexes, embedded in shared memory and
+// initialised once by the process that creates the segment
+int shared_mutex_init(pthread_mutex_t *mutex);
+// Returns 1 if the previous owner died holding the lock (the caller should
+// repair the data it protects), 0 otherwise
+int shared_mutex_lock(pthread_mutex_t *mutex);
+void shared_mutex_unlock(pthread_mutex_t *mutex);
+void shared_mutex_destroy(pthread_mutex_t *mutex);
 
 // Reset all semaphores at once
 void reset_all_semaphores(void);
 
-#endif // SEMAPHORES_UTILS_H
\ No newline at end of file
+#endif // SEMAPHORES_UTILS_H
@@ -0,0 +1,46 @@
+//
+// Sequence locks for data that one writer at a time updates in place and
+// many readers copy out (graphics, the chef rebalancer, statistics).
+//
+// The writer bumps the sequence to odd before an update and back to even
+// after it; it never waits for readers. A reader copies the data and retries
+// if the sequence was odd or changed meanwhile, so its copy is always a
+// state the writer actually published. Writers of the same data must still
+// be serialised by the caller (a mutex, or a single owner).
+//
+// A writer killed mid-update leaves the sequence odd. The next writer of
+// the data repairs it in seqlock_write_begin, but a slot whose only writer
+// was that process (a chef or baker slot) never gets another one, so
+// readers of such data use seqlock_read_copy_bounded instead of waiting on
+// the sequence forever.
+//
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    uint32_t sequence;      // Odd while a write is in progress
+} SeqLock;
+
+void seqlock_init(SeqLock *lock);
+
+// Also takes over a sequence left odd by a writer that died mid-update
+void seqlock_write_begin(SeqLock *lock);
+void seqlock_write_end(SeqLock *lock);
+
+// Low-level read protocol: copy between begin and retry, loop while retry is 1
+uint32_t seqlock_read_begin(const SeqLock *lock);
+int seqlock_read_retry(const SeqLock *lock, uint32_t start);
+
+// Copy size bytes from src, guarded by lock, into dst as one consistent state
+void seqlock_read_copy(const SeqLock *lock, void *dst, const void *src, size_t size);
+
+// seqlock_read_copy that gives up once the sequence stays on one odd value
+// for SEQLOCK_STALL_YIELDS yields, i.e. its writer is gone. Returns -1 then,
+// with dst holding a possibly torn copy; 0 for a consistent one.
+int seqlock_read_copy_bounded(const SeqLock *lock, void *dst, const void *src, size_t size);
+
+#endif // SEQLOCK_H
@@ -1,18 +1,23 @@
 #ifndef SHARED_MEM_UTILS_H
 #define SHARED_MEM_UTILS_H
-#define GAME_SHM_NAME "/game_shared_mem"
-#define CUSTOMER_QUEUE_SHM_NAME "/customer_queue_shm"
+#include "ipc_names.h"
+
+#define GAME_SHM_NAME ipc_name(IPC_GAME_SHM)
+#define CUSTOMER_QUEUE_SHM_NAME ipc_name(IPC_CUSTOMER_QUEUE_SHM)
+#define BAKERY_ARENA_SHM_NAME ipc_name(IPC_ARENA_SHM)
 
 #include "game.h"
-#include "queue.h"
 
 
+// Launcher: create the game segment sized for config and catalog, write its
+// header and copy the catalog products in
+int create_shared_memory(const Config *config, const ProductCatalog *catalog, Game **shared_game);
+// Every other process: map the segment the launcher created
 int setup_shared_memory(Game **shared_game);
+Game *map_shared_game(int shm_fd);
+void unmap_shared_game(Game *shared_game);
 void cleanup_shared_memory(Game *shared_game);
 
-void cleanup_queue_shared_memory(queue_shm *queue_shm, size_t capacity);
-void setup_queue_shared_memory(queue_shm **queue_shm, size_t capacity);
-
 
 
 
@@ -0,0 +1,68 @@
+//
+// Slab allocator over a named shared memory segment.
+//
+// The arena hands out blocks of a few power-of-two size classes. A block is
+// addressed by its ShmRef, the offset from the start of the segment, so a
+// process can allocate an object once and pass the small ref through a
+// message queue or channel whatever address the receiver mapped the
+// segment at.
+//
+// Each class keeps a lock-free free list (a stack whose head carries a tag
+// against ABA) fed by a bump pointer that carves new blocks. On top of that
+// every thread keeps a small cache of free blocks per class, so most allocs
+// and frees touch no shared cache line. Carved blocks are never given back
+// to the segment: a stale read of a free list link is still mapped memory.
+//
+
+#ifndef SHM_ARENA_H
+#define SHM_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cache_line.h"
+
+typedef uint32_t ShmRef;          // Offset into the arena, 0 is no block
+#define SHM_REF_NULL 0
+
+#define SHM_ARENA_MIN_BLOCK 64    // Smallest class; each next one doubles
+#define SHM_ARENA_CLASSES 6       // 64 B .. 2 KB blocks
+#define SHM_ARENA_CACHE 16        // Free blocks one thread keeps per class
+
+typedef struct {
+    uint64_t head CACHE_ALIGNED;  // Tag << 32 | ref of the first free block
+} ArenaFreeList;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t size;                // Bytes in the segment
+    uint32_t data;                // Ref of the first block
+    uint32_t top CACHE_ALIGNED;   // Bump pointer, everything below is carved
+    ArenaFreeList free[SHM_ARENA_CLASSES];
+} ShmArena;
+
+// Segment bytes for payload bytes worth of blocks
+size_t shm_arena_size(size_t payload);
+
+// Bytes of arena an object of size bytes takes up, 0 if no class fits it
+size_t shm_arena_block_size(size_t size);
+
+// The launcher creates and lays out the segment, everyone else maps it
+ShmArena *shm_arena_create(const char *name, size_t size);
+ShmArena *shm_arena_map(const char *name);
+void shm_arena_unmap(ShmArena *arena);
+
+// SHM_REF_NULL once the arena is out of blocks of that class
+ShmRef shm_arena_alloc(ShmArena *arena, size_t size);
+void shm_arena_free(ShmArena *arena, ShmRef ref);
+
+// Hand this thread's cached blocks back, e.g. before the thread exits
+void shm_arena_flush_cache(ShmArena *arena);
+
+// Bytes carved from the segment so far (a snapshot)
+size_t shm_arena_carved(const ShmArena *arena);
+
+static inline void *shm_arena_ptr(ShmArena *arena, ShmRef ref) {
+    return ref == SHM_REF_NULL ? NULL : (unsigned char *) arena + ref;
+}
+
+#endif // SHM_ARENA_H
@@ -0,0 +1,40 @@
+//
+// Simulated clock shared by every process through the Game segment.
+//
+// All waits go through sim_sleep, which divides the simulated duration by
+// TIME_SCALE, so the whole process tree can run faster than real time.
+//
+
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <time.h>
+
+typedef struct {
+    double time_scale;        // Simulated seconds per real second
+    struct timespec origin;   // CLOCK_MONOTONIC reading when the clock started
+} SimClock;
+
+void sim_clock_init(SimClock *clock, double time_scale);
+
+// Simulated seconds since sim_clock_init
+double sim_now(const SimClock *clock);
+
+// Real time a wait of the given simulated seconds takes, for timed waits
+// that do not go through sim_sleep (futexes)
+struct timespec sim_real_timespec(const SimClock *clock, double seconds);
+
+// Wait for the given simulated seconds. Like sleep(), a signal handler cuts
+// the wait short; the simulated time still left is returned.
+double sim_sleep(const SimClock *clock, double seconds);
+
+// Lets a user-space scheduler take over sim_sleep on the calling thread
+// (the coroutine scheduler parks the running coroutine instead of blocking)
+typedef double (*sim_sleep_hook)(const SimClock *clock, double seconds);
+void sim_clock_set_sleep_hook(sim_sleep_hook hook);
+
+// Deliver SIGALRM every interval simulated seconds (replaces alarm(1) loops)
+int sim_clock_start_ticks(const SimClock *clock, double interval);
+void sim_clock_stop_ticks(void);
+
+#endif // SIM_CLOCK_H
@@ -0,0 +1,23 @@
+//
+// Headless discrete-event simulation of the bakery.
+//
+// Runs the chef, baker, oven, supply chain, seller and customer logic against
+// a private Game struct, advancing a simulated clock from event to event
+// instead of sleeping, so a whole day finishes in milliseconds.
+//
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "game.h"
+
+typedef struct {
+    long events_processed;  // Number of events taken from the calendar
+    double simulated_time;  // Simulated seconds covered by the run
+} SimStats;
+
+// game must be laid out with its config and catalog by the caller.
+// game->stats (served, frustrated, profit, ...) holds the result.
+int run_headless_simulation(Game *game, unsigned int seed, SimStats *stats);
+
+#endif // SIMULATION_H
@@ -7,11 +7,39 @@
 
 #include <semaphore.h>
 #include "products.h"
+#include "random.h"
+#include "ipc_names.h"
+#include "shm_arena.h"
+
+// Message queue key shared by the supply chain manager and the supply chains
+#define SUPPLY_CHAIN_MSG_KEY ipc_key(IPC_SUPPLY_CHAIN_KEY)
+
+struct Game;
+
+#define SUPPLY_ORDERS_PER_CHAIN 16   // Orders a chain may have queued before the manager holds off
+
+// A supply order lives in the bakery arena, the chain frees it once delivered
+typedef struct {
+    int count;
+    Ingredient ingredients[]; // Ingredient data
+} SupplyOrder;
 
 // Message structures for supply chain communication
 typedef struct {
     long mtype; // Message type
-    Ingredient ingredients[]; // Ingredient data
+    ShmRef order; // SupplyOrder in the bakery arena
 } SupplyChainMessage;
 
-#endif // SUPPLY_CHAIN_H
\ No newline at end of file
+static inline size_t supply_order_size(int ingredients) {
+    return sizeof(SupplyOrder) + sizeof(Ingredient) * (size_t) (ingredients > 0 ? ingredients : 0);
+}
+
+// Order ingredients that run below 20% from one of the chains (by mtype)
+void request_supplies(struct Game *game, ShmArena *arena, int msg_queue_id,
+                      const long *chain_mtypes, int num_chains, RandomStream *rng);
+
+// Deliver one pending order addressed to mtype, if any.
+// Returns 1 if an order was delivered, 0 if none was pending, -1 if the queue is gone.
+int deliver_supplies(struct Game *game, ShmArena *arena, int msg_queue_id, long mtype, RandomStream *rng);
+
+#endif // SUPPLY_CHAIN_H
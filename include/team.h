@@ -2,6 +2,8 @@
 #define TEAM_H
 
 #include "products.h"
+#include "cache_line.h"
+#include "seqlock.h"
 #include <semaphore.h>
 #include <sys/types.h>
 
@@ -33,6 +35,7 @@ typedef struct {
 } BakerTeam;
 
 typedef struct {
+    SeqLock seq;            // Guards Item and is_active for readers
     int id;
     ChefTeam team;
     pid_t pid;
@@ -40,16 +43,15 @@ typedef struct {
     int items_produced;
     char Item[MAX_NAME_LENGTH];
     ProductCategory* specialization;
-    sem_t* inventory_sem;
-    sem_t* ready_products_sem;
-} Chef;
+} CACHE_ALIGNED Chef;     // Written by its own chef only
 
 
 typedef struct {
+    SeqLock seq;            // Guards state and Item for readers
     Team team_name;         // Team name
     State state;           // State of the baker
     char Item[MAX_NAME_LENGTH]; // Item name
-} Baker;
+} CACHE_ALIGNED Baker;    // Written by its own baker only
 
 
 void init_team(BakerTeam *team, const char *name);
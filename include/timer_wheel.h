@@ -0,0 +1,59 @@
+//
+// Hierarchical timer wheel living in shared memory.
+//
+// Three levels of 64 slots: level 0 covers 64 ticks, level 1 64^2 and
+// level 2 64^3 ticks (about 7 simulated hours at 100 ms per tick).
+// Scheduling, cancelling and expiring a timer are all O(1); timers in the
+// upper levels are cascaded down as the wheel turns. The timer table is
+// sized by the owner (one timer per oven in the game segment).
+//
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <semaphore.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TIMER_WHEEL_TICK 0.1           // Simulated seconds per wheel tick
+#define TIMER_WHEEL_LEVELS 3
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+
+typedef struct {
+    uint64_t expires;   // Tick the timer fires at
+    int next;           // Next timer in the slot list or -1
+    int prev;           // Previous timer in the slot list or -1
+    int slot;           // Index in heads[] or -1 when not pending
+} TimerEntry;
+
+typedef struct {
+    sem_t lock;                         // Process-shared, protects everything below
+    uint64_t current_tick;
+    int heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+    int timer_count;                    // Timer ids are 0..timer_count-1 (e.g. oven index)
+    ptrdiff_t timers;                   // Where the TimerEntry table is, in bytes from this struct
+} TimerWheel;
+
+// The table lives outside the struct; a relative offset finds it at
+// whatever address a process maps the two
+static inline TimerEntry *timer_wheel_timers(const TimerWheel *wheel) {
+    return (TimerEntry *) ((char *) wheel + wheel->timers);
+}
+
+// Runs with the wheel locked, so it must not call back into the wheel
+typedef void (*timer_callback)(int timer_id, void *context);
+
+// timers holds timer_count entries and must stay mapped wherever wheel is
+int timer_wheel_init(TimerWheel *wheel, TimerEntry *timers, int timer_count);
+void timer_wheel_destroy(TimerWheel *wheel);
+
+// Arm (or re-arm) timer_id to fire at the given simulated time
+int timer_wheel_schedule(TimerWheel *wheel, int timer_id, double expires_at);
+int timer_wheel_cancel(TimerWheel *wheel, int timer_id);
+
+// Turn the wheel up to the simulated time now, firing every due timer.
+// Returns the number of timers that fired.
+int timer_wheel_advance(TimerWheel *wheel, double now, timer_callback callback, void *context);
+
+#endif // TIMER_WHEEL_H
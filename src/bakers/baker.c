@@ -14,6 +14,7 @@
  #include "bakery_utils.h"
  #include "products.h"
  #include "semaphores_utils.h"
+ #include "shared_mem_utils.h"
  #include "bakery_message.h"
  
  #define TEAM_COUNT      3
@@ -29,8 +30,7 @@
  }
  
 
-int msg_queue_id = -1;  /* Baker manager queue id */
- static int   in_q                = -1;
+ static ChannelSet *channels     = NULL;  /* Bake channels, laid out by main */
  static pid_t manager_pgid        = 0;  
  
 
@@ -39,15 +39,13 @@ int msg_queue_id = -1;  /* Baker manager queue id */
      static int done = 0;           
      if (done) return;  done = 1;
  
-     if (in_q != -1)             msgctl(in_q, IPC_RMID, NULL);
-     
-    if (msg_queue_id != -1)    msgctl(msg_queue_id, IPC_RMID, NULL);
+     if (channels != NULL)       channel_set_shutdown(channels);
  
      if (manager_pgid > 0)
          kill(-manager_pgid, SIGTERM);
  
-     write(STDERR_FILENO,
-           "\n[manager] graceful shutdown – IPC queues removed\n", 53);
+     static const char note[] = "\n[manager] graceful shutdown – bake channels closed\n";
+     write(STDERR_FILENO, note, sizeof note - 1);
  
      if (signo != 0) _exit(0);
  }
@@ -74,84 +72,50 @@ int msg_queue_id = -1;  /* Baker manager queue id */
      sigaction(SIGTERM, &sa, NULL);
  
 
-     int shm_fd = shm_open("/game_shared_mem", O_RDWR, 0666);
+     int shm_fd = shm_open(GAME_SHM_NAME, O_RDWR, 0666);
      if (shm_fd == -1) { perror("shm_open"); exit(EXIT_FAILURE); }
  
-     Game *game = mmap(NULL, sizeof(Game),
-                       PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-     if (game == MAP_FAILED) { perror("mmap"); exit(EXIT_FAILURE); }
+     Game *game = map_shared_game(shm_fd);
+     if (game == NULL) exit(EXIT_FAILURE);
      close(shm_fd);
  
      printf("********** Bakery Simulation (manager) **********\n");
      print_config(&game->config);
 
-     for (int i = 0; i < TEAM_COUNT; ++i) {
-         msg_queue_id = msgget(MANAGER_BAKERS, 0666 | IPC_CREAT);
-         if (msg_queue_id == -1) { perror("msgget team"); exit(EXIT_FAILURE); }
-     }
+     channels = open_bake_channels(0);
+     if (channels == NULL) exit(EXIT_FAILURE);
  
      /* ---------- fork baker_workers -------------------------------- */
      BakerTeam teams[TEAM_COUNT];
-     distribute_bakers_locally(&game->config, teams);
+     RandomStream rng;
+     random_stream_init(&rng, game->config.SEED, RANDOM_BAKER_MANAGER, 0);
+     distribute_bakers_locally(&game->config, teams, &rng);
      int baker_count = 0;
  
      for (int t = 0; t < TEAM_COUNT; ++t)
          for (int b = 0; b < teams[t].number_of_bakers; ++b) {
-             if (fork() == 0) {   
-                int id = baker_count++;           /* child process */
-                 char q_s[16], team_s[8], id_s[8];
+             int id = baker_count++;
+             if (fork() == 0) {                   /* child process */
+                 char team_s[8], id_s[8];
                  snprintf(id_s, sizeof id_s, "%d", id);  // Using id instead of baker_count
 
                  
                  // store the bakers' info in array
-                 game->info.bakers[id].team_name = teams[t].team_name;
-                 game->info.bakers[id].state = BAKER_IDLE;
+                 game_baker(game, id)->team_name = teams[t].team_name;
+                 game_baker(game, id)->state = BAKER_IDLE;
 
                  
-                 snprintf(q_s, sizeof q_s, "%d", msg_queue_id);
                  snprintf(team_s, sizeof team_s, "%d", teams[t].team_name);
-                 execl("./baker_worker", "baker_worker", q_s, team_s, id_s, NULL);
+                 execl("./baker_worker", "baker_worker", team_s, id_s, NULL);
                  perror("execl"); _exit(EXIT_FAILURE);
              }
          }
  
-     /* ---------- public front‑door queue --------------------------- */
-     in_q = msgget(CHEF_BAKER_KEY, 0666 | IPC_CREAT);
-     if (in_q == -1) { perror("msgget input"); exit(EXIT_FAILURE); }
- 
-     printf("Manager ready – public queue key 0x%X  (id %d)\n",
-        CHEF_BAKER_KEY, in_q);
-     puts("Send BakeryMessage structs here to feed the bakers…");
+     printf("Manager ready – dispatching the chef channel to %d team channels\n",
+            NUM_BAKERY_TEAMS);
  
      /* ---------- dispatcher loop ----------------------------------- */
-     ChefMessage msg;
-     while (1) {
-        // receive a message from the chef manager
-        // baker manager receives all messages from the chef manager, so mtype = 0
-
-        fflush(stdout);
-
-         ssize_t r = msgrcv(in_q, &msg, sizeof(ChefMessage) - sizeof(long), 0, 0);
-         
-         if (r == -1) {
-             if (errno == EINTR) continue;          /* interrupted by signal */
-             perror("manager msgrcv"); continue;
-         }
-         
-
-         int baker_team = get_baker_team_from_chef_team(msg.source_team);
-         msg.mtype = baker_team + 1;  /* mtype = team id + 1 */
-         if (msgsnd(msg_queue_id, &msg,
-                    sizeof msg - sizeof(long), 0) == -1) {
-             perror("manager msgsnd");
-         } else {
-             const char *team =
-                 (baker_team == 0) ? "Bread" :
-                 (baker_team == 1) ? "Cake/Sweet" : "Patisserie";
-             printf("→ dispatched %-20s to %s queue (id %d)\n",
-                    msg.product_name, team, msg_queue_id);
-         }
-     }
-     /* never reached */
+     run_baker_dispatcher(channels);
+ 
      return 0;
  }
@@ -6,6 +6,12 @@
 #include <stdio.h>
 #include <unistd.h>  // For fork() and execl()
 #include <sys/types.h> // For pid_t
+#include <sys/msg.h>
+#include <errno.h>
+#include "game.h"
+#include "chef.h"
+#include "bakery_message.h"
+#include "coroutine.h"
 
 
 const char* get_team_name_str(Team team) {
@@ -32,7 +38,7 @@ void deserialize_baker_team(const char *buffer, BakerTeam *team) {
 }
 
 // Distributes bakers among the three teams
-void distribute_bakers_locally(Config* config, BakerTeam teams[NUM_BAKERY_TEAMS]) {
+void distribute_bakers_locally(Config* config, BakerTeam teams[NUM_BAKERY_TEAMS], RandomStream *rng) {
     int remaining_bakers = config->NUM_BAKERS;
     int min_bakers_per_team = 1; // Ensure at least one baker per team
 
@@ -45,7 +51,7 @@ void distribute_bakers_locally(Config* config, BakerTeam teams[NUM_BAKERY_TEAMS]
 
     // Distribute remaining bakers randomly
     while (remaining_bakers > 0) {
-        int team_index = rand() % NUM_BAKERY_TEAMS;
+        int team_index = random_below(rng, NUM_BAKERY_TEAMS);
         teams[team_index].number_of_bakers++;
         remaining_bakers--;
     }
@@ -89,3 +95,176 @@ pid_t start_process_baker(const char *binary, BakerTeam *team,
     }
     return pid;
 }
+
+// Prepares one unit, bakes it in a free oven and moves it to the ready
+// products. Returns -1 if the game ended before an oven came free.
+static int bake_unit(Game *game, Team my_team, int id, RandomStream *rng,
+                     ChefTeam source_team, int product_index) {
+    ProductType tp = get_product_type_for_team(source_team);
+    const char *name = game_product(game, tp, product_index)->name;
+    Baker *self = game_baker(game, id);
+    int oven_idx = -1;
+
+    int prep = random_int(rng, game->config.MIN_BAKE_TIME, game->config.MAX_BAKE_TIME);
+
+    seqlock_write_begin(&self->seq);
+    strncpy(self->Item, name, MAX_NAME_LENGTH - 1);
+    self->Item[MAX_NAME_LENGTH - 1] = '\0';
+    seqlock_write_end(&self->seq);
+
+    printf("[Baker %s] Preparing %s (%d s)\n",
+           get_team_name_str(my_team), name, prep);
+    sim_sleep(&game->clock, prep);
+
+    /* ---------- find a free oven ----------------------- */
+    while (oven_idx == -1 && !__atomic_load_n(&game->game_over, __ATOMIC_ACQUIRE)) {
+        for (int i = 0; i < game->layout.oven_slots; ++i) {
+            int bake_time = random_int(rng, game->config.MIN_OVEN_TIME, game->config.MAX_OVEN_TIME);
+            double ready_at = sim_now(&game->clock) + bake_time;
+            if (put_item_in_oven(game_oven(game, i), name,
+                                 get_team_name_str(my_team), bake_time, ready_at)) {
+                timer_wheel_schedule(&game->oven_timers, i, ready_at);
+                oven_idx = i;
+                seqlock_write_begin(&self->seq);
+                self->state = BAKER_BUSY;
+                seqlock_write_end(&self->seq);
+                printf("[Baker %s] Placed %s in oven %d for %d s\n",
+                       get_team_name_str(my_team), name, i, bake_time);
+                break;
+            }
+        }
+        if (oven_idx == -1) {
+            printf("[Baker %s] No oven free – waiting\n", get_team_name_str(my_team));
+            sim_sleep(&game->clock, 1);
+        }
+    }
+    if (oven_idx == -1) {
+        return -1;
+    }
+
+    /* ---------- baking ---------------------------------- */
+    // The clock's timer wheel clears is_busy when the bake is done
+    // and wakes us through the futex on that word
+    Oven *oven = game_oven(game, oven_idx);
+    while (__atomic_load_n(&oven->is_busy, __ATOMIC_ACQUIRE)) {
+        coro_futex_wait((uint32_t *) &oven->is_busy, 1);
+    }
+
+    add_ready_product(&game->ready_products, tp, product_index, 1);
+    printf("[Baker %s] Finished %s in oven %d\n",
+           get_team_name_str(my_team), name, oven_idx);
+
+    seqlock_write_begin(&self->seq);
+    self->state = BAKER_IDLE;
+    seqlock_write_end(&self->seq);
+    return 0;
+}
+
+// Baker event loop: takes batches of its own team and bakes them unit by
+// unit. Returns once the bake channels are shut down or the game is over.
+void run_baker_worker(Game *game, ChannelSet *channels, Team my_team, int id) {
+    game_baker(game, id)->state = BAKER_IDLE;
+    RandomStream rng;
+    random_stream_init(&rng, game->config.SEED, RANDOM_BAKER, id);
+
+    while (!__atomic_load_n(&game->game_over, __ATOMIC_ACQUIRE)) {
+        /* ---------- idle: wait for new job ----------------- */
+        // The dispatcher puts every batch on its baker team's channel
+        ChefBatch batch;
+        if (channel_recv(channels, BAKE_CHANNEL_TEAMS + my_team, &batch) == -1) {
+            return;
+        }
+
+        for (int i = 0; i < batch.entry_count; i++) {
+            for (int unit = 0; unit < batch.entries[i].quantity; unit++) {
+                if (bake_unit(game, my_team, id, &rng, batch.source_team,
+                              batch.entries[i].product_index) == -1) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+#define DISPATCH_BATCH_UNITS 4   // Most units one baker takes off the channel at once
+
+// Hand a chef team's pending units to its baker team, split so every baker
+// waiting on the channel gets a share and no baker holds more than
+// DISPATCH_BATCH_UNITS while its teammates might be idle
+static int dispatch_batch(ChannelSet *channels, const ChefBatch *batch) {
+    int baker_team = get_baker_team_from_chef_team(batch->source_team);
+    int channel = BAKE_CHANNEL_TEAMS + baker_team;
+    int units = chef_batch_units(batch);
+
+    int parts = (units + DISPATCH_BATCH_UNITS - 1) / DISPATCH_BATCH_UNITS;
+    int waiting = (int) channel_waiting_receivers(channels, channel);
+    if (parts < waiting) {
+        parts = waiting < units ? waiting : units;
+    }
+    int per_part = (units + parts - 1) / parts;
+
+    ChefBatch part = {.mtype = baker_team + 1, .source_team = batch->source_team};
+    int in_part = 0, sent = 0;
+    for (int i = 0; i < batch->entry_count; i++) {
+        for (int unit = 0; unit < batch->entries[i].quantity; unit++) {
+            chef_batch_add(&part, batch->entries[i].product_index, 1);
+            if (++in_part == per_part) {
+                if (channel_send(channels, channel, &part) == -1) {
+                    return -1;
+                }
+                part.entry_count = 0;
+                in_part = 0;
+                sent++;
+            }
+        }
+    }
+    if (in_part > 0) {
+        if (channel_send(channels, channel, &part) == -1) {
+            return -1;
+        }
+        sent++;
+    }
+    printf("→ dispatched %d items in %d batches to %s channel\n",
+           units, sent, get_team_name_str(baker_team));
+    return 0;
+}
+
+// Routes chef batches from the dispatch channel to their baker team's
+// channel (mtype = team + 1), merging everything pending per chef team
+// first. Returns once the channels are shut down.
+void run_baker_dispatcher(ChannelSet *channels) {
+    ChefBatch batch;
+
+    while (1) {
+        fflush(stdout);
+
+        if (channel_recv(channels, BAKE_CHANNEL_DISPATCH, &batch) == -1) {
+            return;
+        }
+
+        ChefBatch pending[TEAM_COUNT];
+        for (int i = 0; i < TEAM_COUNT; i++) {
+            pending[i].source_team = i;
+            pending[i].entry_count = 0;
+        }
+
+        do {
+            ChefBatch *merged = &pending[batch.source_team];
+            for (int i = 0; i < batch.entry_count; i++) {
+                if (chef_batch_add(merged, batch.entries[i].product_index, batch.entries[i].quantity) == -1) {
+                    if (dispatch_batch(channels, merged) == -1) {
+                        return;
+                    }
+                    merged->entry_count = 0;
+                    chef_batch_add(merged, batch.entries[i].product_index, batch.entries[i].quantity);
+                }
+            }
+        } while (channel_try_recv(channels, BAKE_CHANNEL_DISPATCH, &batch) == 0);
+
+        for (int i = 0; i < TEAM_COUNT; i++) {
+            if (pending[i].entry_count > 0 && dispatch_batch(channels, &pending[i]) == -1) {
+                return;
+            }
+        }
+    }
+}
@@ -7,16 +7,16 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <semaphore.h>
+#include "ipc_names.h"
 
 
-#define SEM_OVEN_NAME_BASE "/oven_sem_"
-#define MAX_NUM_OVENS 10
-
-sem_t *oven_sems[MAX_NUM_OVENS];
+// One named semaphore per oven, as many as the game has oven slots
+static sem_t **oven_sems = NULL;
+static int oven_sem_count = 0;
 
 // Generate a unique semaphore name for each oven
 void get_oven_sem_name(int oven_id, char *buffer, size_t size) {
-    snprintf(buffer, size, "%s%d", SEM_OVEN_NAME_BASE, oven_id);
+    snprintf(buffer, size, "%s_%d", ipc_name(IPC_OVEN_SEM), oven_id);
 }
 
 // Initialize oven struct
@@ -24,12 +24,20 @@ void init_oven(Oven *oven, int id) {
     oven->id = id;
     oven->is_busy = 0;
     oven->time_left = 0;
+    oven->ready_at = 0;
     oven->item_name[0] = '\0';
     oven->team_name[0] = '\0';
 }
 
 // Setup semaphore for each oven
 int setup_oven_semaphores(int num_ovens) {
+    oven_sems = calloc(num_ovens > 0 ? num_ovens : 1, sizeof(sem_t *));
+    if (oven_sems == NULL) {
+        perror("Failed to allocate oven semaphores");
+        return -1;
+    }
+    oven_sem_count = num_ovens;
+
     for (int i = 0; i < num_ovens; i++) {
         char sem_name[64];
         get_oven_sem_name(i, sem_name, sizeof(sem_name));
@@ -59,7 +67,7 @@ void unlock_oven(int oven_id) {
 }
 
 // Place an item in the oven (with locking)
-int put_item_in_oven(Oven *oven, const char *item_name, const char *team_name, int baking_time) {
+int put_item_in_oven(Oven *oven, const char *item_name, const char *team_name, int baking_time, double ready_at) {
     lock_oven(oven->id);
 
     if (oven->is_busy) {
@@ -67,10 +75,13 @@ int put_item_in_oven(Oven *oven, const char *item_name, const char *team_name, i
         return 0;
     }
 
-    oven->is_busy = 1;
+    seqlock_write_begin(&oven->seq);
     oven->time_left = baking_time;
+    oven->ready_at = ready_at;
+    oven->is_busy = 1;
     strcpy(oven->item_name, item_name);
     strcpy(oven->team_name, team_name);
+    seqlock_write_end(&oven->seq);
 
     unlock_oven(oven->id);
     return 1;
@@ -83,6 +94,7 @@ int oven_tick(Oven *oven) {
     lock_oven(oven->id);
 
     if (oven->is_busy) {
+        seqlock_write_begin(&oven->seq);
         oven->time_left--;
         if (oven->time_left <= 0) {
             oven->is_busy = 0;
@@ -91,6 +103,7 @@ int oven_tick(Oven *oven) {
             oven->team_name[0] = '\0';
             finished = 1;
         }
+        seqlock_write_end(&oven->seq);
     }
 
     unlock_oven(oven->id);
@@ -101,7 +114,12 @@ void cleanup_oven_semaphores(int num_ovens) {
     for (int i = 0; i < num_ovens; i++) {
         char sem_name[64];
         get_oven_sem_name(i, sem_name, sizeof(sem_name));
-        sem_close(oven_sems[i]);
+        if (i < oven_sem_count && oven_sems[i] != NULL && oven_sems[i] != SEM_FAILED) {
+            sem_close(oven_sems[i]);
+        }
         sem_unlink(sem_name);
     }
+    free(oven_sems);
+    oven_sems = NULL;
+    oven_sem_count = 0;
 }
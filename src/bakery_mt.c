@@ -0,0 +1,427 @@
+//
+// Single-process runtime: every role runs as a pthread sharing one Game.
+//
+// Chefs, bakers, supply chains, sellers and the managers are threads; their
+// queues are private to this process, only the bake channels segment is
+// named like in the multi-process build. Customers are actors inside the
+// customer manager thread. The Game still lives in the named shared memory
+// so graphics can attach to it.
+//
+// With --coroutines N, chefs and bakers run as coroutines spread over N
+// scheduler threads instead of one thread each.
+//
+// Usage: bakery_mt [--graphics] [--coroutines N]
+//
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/msg.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "config.h"
+#include "coroutine.h"
+#include "game.h"
+#include "chef.h"
+#include "bakery_utils.h"
+#include "seller.h"
+#include "seller_worker.h"
+#include "supply_chain.h"
+#include "customer_manager.h"
+#include "random.h"
+#include "shared_mem_utils.h"
+#include "semaphores_utils.h"
+#include "oven.h"
+
+#define MAX_SCHEDULERS 64
+#define EXTRA_THREADS 16   // Managers, dispatcher and clock on top of the staff
+
+// Per-thread arguments; which fields are used depends on the role
+typedef struct {
+    Game *game;
+    int id;
+    int team;
+    int msg_queue_id;
+    int out_queue_id;
+    ChannelSet *channels;
+    ShmArena *arena;
+} ActorArgs;
+
+static Game *shared_game = NULL;
+static ChefManager *chef_manager = NULL;
+static CustomerManager customer_manager;
+static volatile int sellers_running = 1;
+
+// Sized from the config before the first actor starts; threads keep
+// pointers into actor_args, so neither array ever moves
+static long *supply_chain_mtypes = NULL;
+static ActorArgs *actor_args = NULL;
+static int actor_count = 0;
+static pthread_t *threads = NULL;
+static int thread_count = 0;
+static int max_threads = 0;
+
+static CoroScheduler schedulers[MAX_SCHEDULERS];
+static int scheduler_count = 0;   // 0: chefs and bakers get their own threads
+static int next_scheduler = 0;
+
+static ActorArgs *store_args(ActorArgs args) {
+    if (actor_count == max_threads) {
+        fprintf(stderr, "Too many actors\n");
+        return NULL;
+    }
+    actor_args[actor_count] = args;
+    return &actor_args[actor_count++];
+}
+
+static int start_thread(void *(*routine)(void *), void *arg) {
+    if (thread_count == max_threads) {
+        fprintf(stderr, "Too many threads\n");
+        return -1;
+    }
+    if (pthread_create(&threads[thread_count], NULL, routine, arg) != 0) {
+        perror("pthread_create");
+        return -1;
+    }
+    thread_count++;
+    return 0;
+}
+
+static int start_actor(void *(*routine)(void *), ActorArgs args) {
+    ActorArgs *stored = store_args(args);
+    return stored ? start_thread(routine, stored) : -1;
+}
+
+// A coroutine on the next scheduler, or a thread when coroutines are off
+static int start_worker(void *(*routine)(void *), coro_fn coroutine, ActorArgs args) {
+    if (scheduler_count == 0) {
+        return start_actor(routine, args);
+    }
+
+    ActorArgs *stored = store_args(args);
+    if (stored == NULL) {
+        return -1;
+    }
+    CoroScheduler *scheduler = &schedulers[next_scheduler++ % scheduler_count];
+    return coro_spawn(scheduler, coroutine, stored) == -1 ? -1 : 0;
+}
+
+/* ---- role threads ------------------------------------------ */
+
+static void *chef_thread(void *arg) {
+    ActorArgs *a = arg;
+    run_chef_worker(a->team, a->channels, a->game, a->id);
+    return NULL;
+}
+
+static void chef_coroutine(void *arg) {
+    chef_thread(arg);
+}
+
+static void *chef_manager_thread(void *arg) {
+    ActorArgs *a = arg;
+    run_chef_manager(chef_manager, a->game);
+    return NULL;
+}
+
+static void *baker_thread(void *arg) {
+    ActorArgs *a = arg;
+    run_baker_worker(a->game, a->channels, a->team, a->id);
+    return NULL;
+}
+
+static void baker_coroutine(void *arg) {
+    baker_thread(arg);
+}
+
+static void *baker_dispatcher_thread(void *arg) {
+    ActorArgs *a = arg;
+    run_baker_dispatcher(a->channels);
+    return NULL;
+}
+
+static void *supply_chain_thread(void *arg) {
+    ActorArgs *a = arg;
+    RandomStream rng;
+    random_stream_init(&rng, a->game->config.SEED, RANDOM_SUPPLY_CHAIN, a->id);
+
+    while (!__atomic_load_n(&a->game->game_over, __ATOMIC_ACQUIRE)) {
+        if (deliver_supplies(a->game, a->arena, a->msg_queue_id, supply_chain_mtypes[a->id], &rng) == -1) {
+            break;
+        }
+        sim_sleep(&a->game->clock, 1);
+    }
+    // Blocks this thread cached go back to the arena with it
+    shm_arena_flush_cache(a->arena);
+    return NULL;
+}
+
+static void *supply_manager_thread(void *arg) {
+    ActorArgs *a = arg;
+    RandomStream rng;
+    random_stream_init(&rng, a->game->config.SEED, RANDOM_SUPPLY_MANAGER, 0);
+
+    while (!__atomic_load_n(&a->game->game_over, __ATOMIC_ACQUIRE)) {
+        request_supplies(a->game, a->arena, a->msg_queue_id,
+                         supply_chain_mtypes, a->game->config.NUM_SUPPLY_CHAIN, &rng);
+        sim_sleep(&a->game->clock, 2);
+    }
+    shm_arena_flush_cache(a->arena);
+    return NULL;
+}
+
+static void *customer_manager_thread(void *arg) {
+    (void) arg;
+    run_customer_manager(&customer_manager);
+    shm_arena_flush_cache(customer_manager.arena);
+    return NULL;
+}
+
+static void *seller_thread(void *arg) {
+    ActorArgs *a = arg;
+    Seller *seller = game_seller(a->game, a->id);
+    SellerContext ctx = {
+        .seller = seller,
+        .game = a->game,
+        .customer_line = customer_manager.customer_line,
+        .arena = customer_manager.arena,
+        .customer_inbox_id = customer_manager.inbox_queue_id,
+        .running = &sellers_running
+    };
+
+    init_seller(seller, a->id);
+    seller_loop(&ctx);
+    shm_arena_flush_cache(ctx.arena);
+    return NULL;
+}
+
+static void *scheduler_thread(void *arg) {
+    coro_scheduler_run(arg);
+    return NULL;
+}
+
+static void *clock_thread(void *arg) {
+    return run_game_clock(((ActorArgs *) arg)->game);
+}
+
+static void handle_kill(int signum) {
+    (void) signum;
+    exit(0);
+}
+
+int main(int argc, char *argv[]) {
+    int with_graphics = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--graphics") == 0) {
+            with_graphics = 1;
+        } else if (strcmp(argv[i], "--coroutines") == 0 && i + 1 < argc) {
+            scheduler_count = atoi(argv[++i]);
+            if (scheduler_count < 1 || scheduler_count > MAX_SCHEDULERS) {
+                fprintf(stderr, "--coroutines takes 1..%d scheduler threads\n", MAX_SCHEDULERS);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Usage: %s [--graphics] [--coroutines N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("********** Bakery Simulation (threads) **********\n\n");
+    fflush(stdout);
+
+    // Name every shared resource after this run before touching any
+    ipc_init_instance();
+    reset_all_semaphores();
+    signal(SIGINT, handle_kill);
+
+    // The config and catalog size the game segment, so they are read first
+    Config loaded;
+    if (load_config(CONFIG_PATH, &loaded) == -1) {
+        printf("Config file failed\n");
+        return 1;
+    }
+    ProductCatalog catalog;
+    if (load_product_catalog(CONFIG_PATH_JSON, &catalog) == -1) {
+        printf("Product catalog file failed\n");
+        return 1;
+    }
+    int shm_fd = create_shared_memory(&loaded, &catalog, &shared_game);
+    free_product_catalog(&catalog);
+
+    // Every actor derives its random stream from this one seed
+    shared_game->config.SEED = resolve_seed(shared_game->config.SEED);
+    printf("Seed: %u\n", shared_game->config.SEED);
+    sim_clock_init(&shared_game->clock, shared_game->config.TIME_SCALE);
+    if (game_reset(shared_game) == -1) {
+        return 1;
+    }
+    // Baker threads lock the ovens like the baker_worker processes do
+    if (setup_oven_semaphores(shared_game->layout.oven_slots) == -1) {
+        return 1;
+    }
+
+    Game *game = shared_game;
+    Config *config = &game->config;
+
+    int num_chefs = game->layout.chef_slots;
+    int num_bakers = game->layout.baker_slots;
+    int num_chains = config->NUM_SUPPLY_CHAIN > 0 ? config->NUM_SUPPLY_CHAIN : 0;
+    int num_sellers = config->NUM_SELLERS > 0 ? config->NUM_SELLERS : 0;
+    max_threads = num_chefs + num_bakers + num_chains + num_sellers + MAX_SCHEDULERS + EXTRA_THREADS;
+    actor_args = malloc(max_threads * sizeof(ActorArgs));
+    threads = malloc(max_threads * sizeof(pthread_t));
+    supply_chain_mtypes = malloc((num_chains > 0 ? num_chains : 1) * sizeof(long));
+    if (actor_args == NULL || threads == NULL || supply_chain_mtypes == NULL) {
+        perror("Failed to allocate actors");
+        return 1;
+    }
+
+    // Customer orders and supply orders are allocated once and passed by ref
+    ShmArena *arena = shm_arena_create(BAKERY_ARENA_SHM_NAME, bakery_arena_size(config));
+    if (arena == NULL) {
+        return 1;
+    }
+
+    int supply_queue = msgget(IPC_PRIVATE, 0666 | IPC_CREAT);
+    ChannelSet *bake_channels = open_bake_channels(1);
+    chef_manager = bake_channels ? init_chef_manager(bake_channels) : NULL;
+    if (supply_queue == -1 || chef_manager == NULL) {
+        perror("Failed to create message queues");
+        return 1;
+    }
+
+    if (init_customer_manager(&customer_manager, game) == -1) {
+        return 1;
+    }
+
+    pid_t graphics_pid = -1;
+    if (with_graphics) {
+        graphics_pid = start_process("./graphics", shm_fd, true);
+    }
+
+    start_actor(clock_thread, (ActorArgs) {.game = game});
+
+    for (int i = 0; i < scheduler_count; i++) {
+        if (coro_scheduler_init(&schedulers[i], &game->clock, num_chefs + num_bakers) == -1) {
+            return 1;
+        }
+    }
+
+    /* ---- chefs ---- */
+    RandomStream rng;
+    random_stream_init(&rng, config->SEED, RANDOM_MAIN, 0);
+
+    int chefs_per_team[TEAM_COUNT] = {0};
+    distribute_chefs(num_chefs, chefs_per_team, &rng);
+
+    int chef_count = 0;
+    for (int team = 0; team < TEAM_COUNT; team++) {
+        for (int i = 0; i < chefs_per_team[team] && chef_count < num_chefs; i++) {
+            int id = chef_count++;
+            Chef *chef = game_chef(game, id);
+            chef->id = id;
+            chef->team = team;
+            chef->is_active = 1;
+            chef->pid = 0;  // Threads are never signalled, see move_chef
+
+            start_worker(chef_thread, chef_coroutine, (ActorArgs) {.game = game, .id = id, .team = team,
+                                                                   .channels = bake_channels});
+        }
+    }
+    game->info.chef_count = chef_count;
+    start_actor(chef_manager_thread, (ActorArgs) {.game = game});
+
+    /* ---- bakers ---- */
+    BakerTeam teams[NUM_BAKERY_TEAMS];
+    distribute_bakers_locally(config, teams, &rng);
+
+    int baker_count = 0;
+    for (int t = 0; t < NUM_BAKERY_TEAMS; t++) {
+        for (int b = 0; b < teams[t].number_of_bakers && baker_count < num_bakers; b++) {
+            int id = baker_count++;
+            game_baker(game, id)->team_name = teams[t].team_name;
+            game_baker(game, id)->state = BAKER_IDLE;
+
+            start_worker(baker_thread, baker_coroutine, (ActorArgs) {.game = game, .id = id,
+                                                                     .team = teams[t].team_name,
+                                                                     .channels = bake_channels});
+        }
+    }
+    // Every coroutine is spawned, the schedulers can start
+    for (int i = 0; i < scheduler_count; i++) {
+        start_thread(scheduler_thread, &schedulers[i]);
+    }
+
+    start_actor(baker_dispatcher_thread, (ActorArgs) {.game = game, .channels = bake_channels});
+
+    /* ---- supply chains ---- */
+    for (int i = 0; i < num_chains; i++) {
+        supply_chain_mtypes[i] = i + 1;  // mtype must be positive
+        start_actor(supply_chain_thread, (ActorArgs) {.game = game, .id = i, .msg_queue_id = supply_queue,
+                                                       .arena = arena});
+    }
+    if (num_chains > 0) {
+        start_actor(supply_manager_thread, (ActorArgs) {.game = game, .msg_queue_id = supply_queue,
+                                                         .arena = arena});
+    }
+
+    /* ---- customers and sellers ---- */
+    start_actor(customer_manager_thread, (ActorArgs) {.game = game});
+
+    for (int i = 0; i < num_sellers; i++) {
+        start_actor(seller_thread, (ActorArgs) {.game = game, .id = i});
+    }
+
+    printf("Started %d threads (%d scheduler threads)\n", thread_count, scheduler_count);
+    fflush(stdout);
+
+    /* sleep until a counter update ends the game */
+    wait_for_game_over(game);
+
+    printf("Game over after %d s: served %d, frustrated %d, complained %d, missing %d, cascade %d, profit %.2f\n",
+           game->elapsed_time,
+           (int) stats_read(&game->stats, STAT_SERVED),
+           (int) stats_read(&game->stats, STAT_FRUSTRATED),
+           (int) stats_read(&game->stats, STAT_COMPLAINED),
+           (int) stats_read(&game->stats, STAT_MISSING),
+           (int) stats_read(&game->stats, STAT_CASCADE),
+           stats_profit(&game->stats));
+    fflush(stdout);
+
+    // Removing the queues and closing the channels unblocks every thread
+    // still waiting in msgrcv or on a channel
+    sellers_running = 0;
+    channel_set_shutdown(bake_channels);
+    msgctl(supply_queue, IPC_RMID, NULL);
+
+    for (int i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    cleanup_customer_manager(&customer_manager);
+    if (graphics_pid > 0) {
+        kill(graphics_pid, SIGINT);
+        waitpid(graphics_pid, NULL, 0);
+    }
+
+    for (int i = 0; i < scheduler_count; i++) {
+        coro_scheduler_destroy(&schedulers[i]);
+    }
+    free(chef_manager);
+    free(actor_args);
+    free(threads);
+    free(supply_chain_mtypes);
+    cleanup_oven_semaphores(game->layout.oven_slots);
+    timer_wheel_destroy(&game->oven_timers);
+    shared_mutex_destroy(&game->ready_products.lock);
+    channel_set_unmap(bake_channels);
+    shm_unlink(BAKE_CHANNEL_SHM_NAME);
+    shm_arena_unmap(arena);
+    shm_unlink(BAKERY_ARENA_SHM_NAME);
+    cleanup_shared_memory(shared_game);
+
+    return 0;
+}
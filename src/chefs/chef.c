@@ -23,47 +23,23 @@ int main(int argc, char *argv[]) {
 
     setup_shared_memory(&game);
 
-    // Setup semaphores
-    sem_t* inventory_sem = setup_inventory_semaphore();
-    sem_t* ready_products_sem = setup_ready_products_semaphore();
-
     // Setup signal handler for chef reassignment
     signal(SIGUSR1, SIG_IGN);  // Parent process ignores the signal
 
-    time_t last_check_time = time(NULL);
-    
-    if (!inventory_sem || !ready_products_sem) {
-        perror("Failed to setup semaphores");
-        exit(1);
-    }
-
-   int msg_queue = msgget(IPC_PRIVATE, 0666 | IPC_CREAT);
-    if (msg_queue == -1) {
-        perror("Failed to create message queue");
+    // main laid out the bake channels before starting us
+    ChannelSet *channels = open_bake_channels(0);
+    if (channels == NULL) {
         exit(1);
     }
 
-
     // Initialize chef manager
-    ChefManager* manager = init_chef_manager(&game->productCatalog,
-                                           inventory_sem,
-                                           ready_products_sem);
-
-    int chefs_per_team[TEAM_COUNT] = {0};  // Initialize all to 0
-    int remaining_chefs = game->config.NUM_CHEFS;
+    ChefManager* manager = init_chef_manager(channels);
 
-    // First assign 1 chef to each team
-    for (int i = 0; i < TEAM_COUNT; i++) {
-        chefs_per_team[i] = 1;
-        remaining_chefs--;
-    }
+    RandomStream rng;
+    random_stream_init(&rng, game->config.SEED, RANDOM_CHEF_MANAGER, 0);
 
-    // Randomly distribute remaining chefs
-    while (remaining_chefs > 0) {
-        int team = rand() % TEAM_COUNT;
-        chefs_per_team[team]++;
-        remaining_chefs--;
-    }
+    int chefs_per_team[TEAM_COUNT] = {0};  // Initialize all to 0
+    distribute_chefs(game->config.NUM_CHEFS, chefs_per_team, &rng);
 
     // Spawn chef workers for each team
     int chef_count = 0;
@@ -72,7 +48,7 @@ int main(int argc, char *argv[]) {
             int id = chef_count++;
             
             // Initialize chef info in parent process
-            Chef* chef = &game->info.chefs[id];
+            Chef* chef = game_chef(game, id);
             chef->id = id;
             chef->team = team;
             chef->is_active = 1;
@@ -81,43 +57,24 @@ int main(int argc, char *argv[]) {
 
             if (pid == 0) {
                 // Child process
-                char mqid_str[16], team_str[8], id_str[8];
+                char team_str[8], id_str[8];
 
-                snprintf(mqid_str, sizeof(mqid_str), "%d", msg_queue);
                 snprintf(team_str, sizeof(team_str), "%d", team);
                 snprintf(id_str, sizeof(id_str), "%d", id);
 
-                execl("./chef_worker", "chef_worker", mqid_str, team_str, id_str, NULL);
+                execl("./chef_worker", "chef_worker", team_str, id_str, NULL);
                 perror("execl failed");
                 exit(1);
             } else if (pid > 0) {
                 // Store PID in parent process
-                game->info.chefs[id].pid = pid;
+                game_chef(game, id)->pid = pid;
             } else {
                 perror("Fork failed");
             }
         }
     }
 
-    int baker_msg_queue = msgget(CHEF_BAKER_KEY, 0666 | IPC_CREAT);
-
-    while (1) {
-        // Process messages from chefs
-        process_chef_messages(manager, msg_queue, baker_msg_queue, game);
-
-        // Check if it's time to rebalance teams
-        time_t current_time = time(NULL);
-        if (current_time - last_check_time >= game->config.REALLOCATION_CHECK_INTERVAL) {
-            balance_teams(game);
-            last_check_time = current_time;
-        }
-
-        usleep(100000);  // Small delay to prevent busy waiting
-    }
+    run_chef_manager(manager, game);
 
-    // Cleanup
-    cleanup_inventory_semaphore_resources(inventory_sem);
-    cleanup_ready_products_semaphore_resources(ready_products_sem);
-    
     return 0;
 }
\ No newline at end of file
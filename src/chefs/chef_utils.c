@@ -22,7 +22,7 @@
 
 
 // initialize manager
-ChefManager* init_chef_manager(ProductCatalog* catalog, sem_t* inv_sem, sem_t* ready_sem) {
+ChefManager* init_chef_manager(ChannelSet *channels) {
     ChefManager* manager = malloc(sizeof(ChefManager));
     if (!manager) {
         perror("Failed to allocate chef manager");
@@ -30,122 +30,146 @@ ChefManager* init_chef_manager(ProductCatalog* catalog, sem_t* inv_sem, sem_t* r
     }
 
     manager->chef_count = 0;
-    manager->product_catalog = catalog;
-    manager->inventory_sem = inv_sem;
-    manager->ready_products_sem = ready_sem;
-
-    // Create message queue for baker communication
-    manager->msg_queue_bakers = msgget(IPC_PRIVATE, 0666 | IPC_CREAT);
-    if (manager->msg_queue_bakers == -1) {
-        perror("Failed to create baker message queue");
-        free(manager);
-        return NULL;
-    }
+    manager->channels = channels;
 
     return manager;
 }
 
-// send messages between chef manager and chefs
-void process_chef_messages(ChefManager* manager, int msg_queue, int baker_msg_queue, Game *game) {
-    
-      
-    // prepare a message for receipt from the chefs  
-    ChefMessage msg;
-    while (msgrcv(msg_queue, &msg, sizeof(ChefMessage) - sizeof(long), 0, IPC_NOWAIT) != -1) {
-            // Forward to baker manager if needed
-        if (msg.source_team != TEAM_SANDWICHES) {
-        
-            if (msgsnd(baker_msg_queue, &msg, sizeof(ChefMessage) - sizeof(long), 0) == -1) {
-                perror("Failed to forward to baker manager");
-            }
-        } else {
-            // Direct to ready products for items that don't need baking
-            ProductType type = get_product_type_for_team(msg.source_team);
+static void forward_chef_batch(ChefManager *manager, ChefBatch *batch, Game *game) {
+    // Forward to baker manager if needed
+    if (batch->source_team != TEAM_SANDWICHES) {
+        if (channel_send(manager->channels, BAKE_CHANNEL_DISPATCH, batch) == -1) {
+            printf("[Chef Manager] Bake channels closed, dropping %d items\n", chef_batch_units(batch));
+        }
+    } else {
+        // Direct to ready products for items that don't need baking
+        ProductType type = get_product_type_for_team(batch->source_team);
+        for (int i = 0; i < batch->entry_count; i++) {
             add_ready_product(&game->ready_products,
                             type,
-                            msg.product_index,
-                            1,
-                            manager->ready_products_sem);
+                            batch->entries[i].product_index,
+                            batch->entries[i].quantity);
+        }
+    }
+    batch->entry_count = 0;
+}
+
+// Merge everything the chefs handed over so far (first included, if given)
+// into one batch per chef team, then forward those
+void process_chef_messages(ChefManager* manager, Game *game, const ChefBatch *first) {
+    ChefBatch pending[TEAM_COUNT];
+    for (int i = 0; i < TEAM_COUNT; i++) {
+        pending[i].mtype = i + 1;
+        pending[i].source_team = i;
+        pending[i].entry_count = 0;
+    }
+
+    ChefBatch batch;
+    int have = first != NULL;
+    if (have) {
+        batch = *first;
+    } else {
+        have = channel_try_recv(manager->channels, BAKE_CHANNEL_CHEFS, &batch) == 0;
+    }
+
+    while (have) {
+        ChefBatch *merged = &pending[batch.source_team];
+        for (int i = 0; i < batch.entry_count; i++) {
+            if (chef_batch_add(merged, batch.entries[i].product_index, batch.entries[i].quantity) == -1) {
+                forward_chef_batch(manager, merged, game);
+                chef_batch_add(merged, batch.entries[i].product_index, batch.entries[i].quantity);
+            }
         }
+        have = channel_try_recv(manager->channels, BAKE_CHANNEL_CHEFS, &batch) == 0;
     }
-    
 
-        // Delay to prevent busy waiting
-        usleep(100000);
+    for (int i = 0; i < TEAM_COUNT; i++) {
+        if (pending[i].entry_count > 0) {
+            forward_chef_batch(manager, &pending[i], game);
+        }
+    }
 }
 
 
 
 
 
-// Function to simulate the work of a chef
-void simulate_chef_work(ChefTeam team, int msg_queue_id, Game *game, int id) {
-    // Set up random seed based on process ID
-    srand(time(NULL) ^ getpid());
+// Split the chefs between the teams: one chef per team first, the rest at random
+void distribute_chefs(int num_chefs, int chefs_per_team[TEAM_COUNT], RandomStream *rng) {
+    int remaining_chefs = num_chefs;
 
-    // Get inventory semaphores
-    sem_t* inventory_sem = setup_inventory_semaphore();
-    sem_t* ready_products_sem = setup_ready_products_semaphore();
+    // First assign 1 chef to each team
+    for (int i = 0; i < TEAM_COUNT; i++) {
+        chefs_per_team[i] = 1;
+        remaining_chefs--;
+    }
 
-    if (!inventory_sem || !ready_products_sem) {
-        perror("Failed to setup semaphores");
-        exit(1);
+    // Randomly distribute remaining chefs
+    while (remaining_chefs > 0) {
+        int team = random_below(rng, TEAM_COUNT);
+        chefs_per_team[team]++;
+        remaining_chefs--;
     }
+}
 
+// Take the ingredients of a recipe from the inventory if all of them are available
+// Returns 1 if the ingredients were taken, 0 if something is missing
+int take_recipe_ingredients(Inventory *inventory, const Product *product) {
+    return reserve_ingredients(inventory, product->ingredients, product->ingredient_count);
+}
+
+// Function to simulate the work of a chef
+void simulate_chef_work(ChefTeam team, ChannelSet *channels, Game *game, int id) {
+    // The inventory is lock-free and ready products carry their own lock
+    run_chef_worker(team, channels, game, id);
+}
+
+// Chef loop, shared by chef_worker processes and the threaded runtime
+void run_chef_worker(ChefTeam team, ChannelSet *channels, Game *game, int id) {
     // Initialize chef state
-    game->info.chefs[id].team = team;
-    game->info.chefs[id].is_active = 1; // Start as active
-    game->info.chefs[id].inventory_sem = inventory_sem;
-    game->info.chefs[id].ready_products_sem = ready_products_sem;
+    Chef *self = game_chef(game, id);
+    self->team = team;
+    self->is_active = 1; // Start as active
+
+    RandomStream rng;
+    random_stream_init(&rng, game->config.SEED, RANDOM_CHEF, id);
 
     printf("[Chef Worker] Started in team %d\n", team);
 
-    while (1) {
-        if (game->info.chefs[id].team != team) {
+    while (!__atomic_load_n(&game->game_over, __ATOMIC_ACQUIRE)) {
+        if (self->team != team) {
             // Update team and specialization
-            team = game->info.chefs[id].team;
+            team = self->team;
             printf("[Chef Worker] Switched to team %d\n", team);
         }
-        // Get team's product category
-        ProductCategory* category = &game->productCatalog.categories[team];
+        // Paste has no catalog category to pick a recipe from
+        if (team == TEAM_PASTE) {
+            sim_sleep(&game->clock, 1);
+            continue;
+        }
 
-        if (category->product_count == 0) {
-            sleep(1);
+        // Team's products come from its catalog category
+        if (game_product_count(game, team) == 0) {
+            sim_sleep(&game->clock, 1);
             continue;
         }
 
         // Select random product from category
-        int product_index = rand() % category->product_count;
-        Product* product = &category->products[product_index];
-
-        // Check if we have enough ingredients
-        lock_inventory(inventory_sem);
-        int has_ingredients = 1;
-
-        // Check if we have enough of each ingredient
-        for (int i = 0; i < product->ingredient_count; i++) {
-            if (game->inventory.quantities[product->ingredients[i].type] <
-                product->ingredients[i].quantity) {
-                has_ingredients = 0;
-                break;
-            }
-        }
+        int product_index = random_below(&rng, game_product_count(game, team));
+        Product* product = game_product(game, team, product_index);
 
         // If we have enough ingredients, proceed with preparation
         // Otherwise, wait for ingredients
-        if (has_ingredients) {
-            // Use ingredients
-            // copy product name into game->info.chefs[id].product_name
-            strncpy(game->info.chefs[id].Item, product->name, MAX_NAME_LENGTH - 1);
-            game->info.chefs[id].Item[MAX_NAME_LENGTH - 1] = '\0';
-            for (int i = 0; i < product->ingredient_count; i++) {
-                game->inventory.quantities[product->ingredients[i].type] -=
-                    product->ingredients[i].quantity;
-            }
-            unlock_inventory(inventory_sem);
-
-            if (!game->info.chefs[id].is_active) {
-                game->info.chefs[id].is_active = 1;
+        if (take_recipe_ingredients(&game->inventory, product)) {
+            // copy product name into our slot
+            int was_active = self->is_active;
+            seqlock_write_begin(&self->seq);
+            strncpy(self->Item, product->name, MAX_NAME_LENGTH - 1);
+            self->Item[MAX_NAME_LENGTH - 1] = '\0';
+            self->is_active = 1;
+            seqlock_write_end(&self->seq);
+
+            if (!was_active) {
                 printf("[Chef Worker Team %d] Waking up, ingredients available\n", team);
             }
 
@@ -153,72 +177,95 @@ void simulate_chef_work(ChefTeam team, int msg_queue_id, Game *game, int id) {
             printf("[Chef Worker Team %d] Starting production of %s\n",
                    team, product->name);
             
-            sleep(product->preparation_time);
+            sim_sleep(&game->clock, product->preparation_time);
 
             // Handle products that don't need baking (sandwiches and paste)
             if (team == TEAM_SANDWICHES || team == TEAM_PASTE) {
                 if (team == TEAM_SANDWICHES) {
                     // Handle sandwiches as before
                     ProductType product_type = get_product_type_for_team(team);
-                    lock_ready_products(ready_products_sem);
+                    // add_ready_product takes the ready products lock itself
                     add_ready_product(&game->ready_products,
                                     product_type,
                                     product_index,
-                                    1,
-                                    ready_products_sem);
-                    unlock_ready_products(ready_products_sem);
+                                    1);
                     printf("[Chef Worker Team %d] Added %s directly to ready products\n",
                            team, product->name);
                 } else if (team == TEAM_PASTE) {
                     // Handle paste by adding to inventory
-                    add_paste(&game->inventory, 1, inventory_sem);
+                    add_paste(&game->inventory, 1);
                     printf("[Chef Worker Team %d] Added paste to inventory (total: %d)\n",
-                           team, get_paste_count(&game->inventory, inventory_sem));
+                           team, get_paste_count(&game->inventory));
                 }
             } else {
                 // Prepare message for chef manager for items that need baking
-                ChefMessage msg;
-                msg.mtype = team + 1;  // Adding 1 to ensure mtype is positive
-                msg.source_team = team;
-                msg.product_index = product_index;
-                strncpy(msg.product_name, product->name, MAX_NAME_LENGTH - 1);
-                msg.product_name[MAX_NAME_LENGTH - 1] = '\0';
-
-                // Send to chef manager
-                if (msgsnd(msg_queue_id, &msg, sizeof(ChefMessage) - sizeof(long), 0) == -1) {
-                    perror("[Chef Worker] Failed to send prepared item");
+                ChefBatch batch = {0};
+                batch.mtype = team + 1;  // Adding 1 to ensure mtype is positive
+                batch.source_team = team;
+                chef_batch_add(&batch, product_index, 1);
+
+                // Hand over to the chef manager
+                if (channel_send(channels, BAKE_CHANNEL_CHEFS, &batch) == -1) {
+                    break;  // Bake channels shut down, the game is over
                 } else {
                     printf("[Chef Worker Team %d] Sent %s to baker\n",
                            team, product->name);
                 }
             }
         } else {
-            unlock_inventory(inventory_sem);
-
-            if (game->info.chefs[id].is_active) {
-                game->info.chefs[id].is_active = 0;
+            if (self->is_active) {
+                seqlock_write_begin(&self->seq);
+                self->is_active = 0;
+                seqlock_write_end(&self->seq);
                 printf("[Chef Worker Team %d] Going to sleep, waiting for ingredients for %s\n",
                        team, product->name);
             }
-            sleep(3); // Sleep while waiting for ingredients
+            sim_sleep(&game->clock, 3); // Sleep while waiting for ingredients
         }
     }
+}
 
-    // Cleanup
-    cleanup_ready_products_semaphore_resources(ready_products_sem);
-    cleanup_inventory_semaphore_resources(inventory_sem);
+
+// Chef manager loop: forwards chef output and rebalances the teams
+void run_chef_manager(ChefManager *manager, Game *game) {
+    double last_check_time = sim_now(&game->clock);
+
+    while (!__atomic_load_n(&game->game_over, __ATOMIC_ACQUIRE)) {
+        // Sleep until a chef hands something over, or 0.1 s for the rebalancing check
+        struct timespec timeout = sim_real_timespec(&game->clock, 0.1);
+        ChefBatch batch;
+        if (channel_recv_timeout(manager->channels, BAKE_CHANNEL_CHEFS, &batch, &timeout) == 0) {
+            process_chef_messages(manager, game, &batch);
+        } else if (__atomic_load_n(&manager->channels->closed, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        // Check if it's time to rebalance teams
+        double current_time = sim_now(&game->clock);
+        if (current_time - last_check_time >= game->config.REALLOCATION_CHECK_INTERVAL) {
+            balance_teams(game);
+            last_check_time = current_time;
+        }
+    }
 }
 
 
 // Function to calculate current production ratios
 void calculate_production_ratios(const ReadyProducts *ready_products, float *ratios) {
-    // Calculate total products for each category
-    int totals[NUM_PRODUCTS] = {0};
-    for (int i = 0; i < NUM_PRODUCTS; i++) {
-        for (int j = 0; j < ready_products->categories[i].product_count; j++) {
-            totals[i] += ready_products->categories[i].quantities[j];
+    // Sum consistent counts instead of counts that change under us
+    const int *quantities = ready_quantities(ready_products);
+    int totals[NUM_PRODUCTS];
+    uint32_t sequence;
+    do {
+        sequence = seqlock_read_begin(&ready_products->seq);
+        for (int i = 0; i < NUM_PRODUCTS; i++) {
+            const ReadyProductCategory *category = &ready_products->categories[i];
+            totals[i] = 0;
+            for (int j = 0; j < category->product_count; j++) {
+                totals[i] += quantities[category->first + j];
+            }
         }
-    }
+    } while (seqlock_read_retry(&ready_products->seq, sequence));
 
     // Calculate ratios relative to average
     float avg = 0;
@@ -238,12 +285,12 @@ void calculate_production_ratios(const ReadyProducts *ready_products, float *rat
 void move_chef(ChefTeam from_team, ChefTeam to_team, Game *game) {
     // Find a chef from the source team
     for (int i = 0; i < game->info.chef_count; i++) {
-        Chef *chef = &game->info.chefs[i];
+        Chef *chef = game_chef(game, i);
         if (chef->team == from_team) {
             // Count chefs in source team to ensure minimum
             int source_team_count = 0;
             for (int j = 0; j < game->info.chef_count; j++) {
-                if (game->info.chefs[j].team == from_team) {
+                if (game_chef(game, j)->team == from_team) {
                     source_team_count++;
                 }
             }
@@ -254,8 +301,10 @@ void move_chef(ChefTeam from_team, ChefTeam to_team, Game *game) {
                 printf("[Chef Manager] Moved chef %d from team %d to team %d\n",
                        chef->id, from_team, to_team);
 
-                // Signal the chef to change team via kill
-                kill(chef->pid, SIGUSR1);
+                // Signal the chef to change team via kill (chefs without a process only poll their team)
+                if (chef->pid > 0) {
+                    kill(chef->pid, SIGUSR1);
+                }
                 return;
             }
         }
@@ -9,20 +9,24 @@
 #include <signal.h>
 #include "shared_mem_utils.h"
 #include "team.h"
+#include "bakery_message.h"
 
 Game* game;
 int main(int argc, char *argv[]) {
-    if (argc != 4) {
-        fprintf(stderr, "Usage: %s <msg_queue_id> <team> <id>\n", argv[0]);
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <team> <id>\n", argv[0]);
         exit(1);
     }
 
     setup_shared_memory(&game);
+    ChannelSet *channels = open_bake_channels(0);
+    if (channels == NULL) {
+        exit(1);
+    }
 
     // Parse arguments
-    int msg_queue_id = atoi(argv[1]);
-    ChefTeam team = atoi(argv[2]);
-    int id = atoi(argv[3]);
+    ChefTeam team = atoi(argv[1]);
+    int id = atoi(argv[2]);
 
     printf("Chef %d started in team %d\n", id, team);
 
@@ -33,7 +37,7 @@ int main(int argc, char *argv[]) {
     sigaction(SIGUSR1, &sa, NULL);
 
     // Start chef work simulation
-    simulate_chef_work(team, msg_queue_id, game, id);
+    simulate_chef_work(team, channels, game, id);
 
     return 0;
 }
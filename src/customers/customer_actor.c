@@ -0,0 +1,227 @@
+//
+// Customer state machine. Each customer is an actor inside the customer
+// manager: sleeps became scheduled events and the seller's signal became a
+// SellerMessage, but the states and transitions are the ones the customer
+// process used to walk through.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/msg.h>
+#include "customer_manager.h"
+#include "random.h"
+
+static void schedule(CustomerManager *manager, CustomerActor *actor, double delay, CustomerEvent event) {
+    int slot = (int) (actor - manager->actors);
+    event_queue_push(&manager->events, manager->now + delay, event, slot, actor->generation);
+}
+
+// Mirror the new state into the customer's line slot
+static void update_state(CustomerManager *manager, CustomerActor *actor, CustomerState new_state) {
+    actor->customer.state = new_state;
+    printf("Customer %d updated state to %d\n", actor->customer.id, new_state);
+
+    customer_line_update(manager->customer_line, actor->customer.pid,
+                         new_state, actor->customer.patience);
+}
+
+// Post the order again on the next tick. A failed post is the bakery's
+// problem, not the customer's: they stay ORDERING and no stat is counted
+static void retry_order(CustomerManager *manager, CustomerActor *actor) {
+    actor->busy = true;   // Keeps handle_state from scheduling a second order
+    schedule(manager, actor, CUSTOMER_TICK, CUSTOMER_EV_ORDER_READY);
+}
+
+void leave_restaurant(CustomerManager *manager, CustomerActor *actor, CustomerState final_state, ActionType action) {
+    Game *game = manager->game;
+
+    actor->customer.state = final_state;
+    manager->active_customers--;
+
+    customer_line_leave(manager->customer_line, actor->customer.pid);
+
+    if (action == LEAVING_NORMALLY) {
+        stats_add(&game->stats, STAT_SERVED, 1);
+        notify_game_state(game);
+    } else {
+        handle_customer_state(manager, final_state, actor->customer.pid);
+    }
+
+    // Free the slot; pending events of this customer are now stale
+    actor->active = false;
+    actor->generation++;
+    manager->free_slots[manager->free_count++] = (int) (actor - manager->actors);
+}
+
+// Returns true if the customer left because of a recent complaint
+static bool check_for_contagion(CustomerManager *manager, CustomerActor *actor) {
+    Game *game = manager->game;
+
+    // Wait for semaphore before reading complaint data
+    sem_wait(manager->complaint_sem);
+    bool has_complaint = game->recent_complaint;
+    pid_t complaining_pid = game->complaining_customer_pid;
+    sem_post(manager->complaint_sem);
+
+    // Skip if no complaints or we're the one complaining
+    if (!has_complaint || complaining_pid == actor->customer.pid) {
+        return false;
+    }
+
+    if (random_float(&actor->rng, 0, 1) < game->config.CUSTOMER_CASCADE_PROBABILITY) {
+        printf("Customer %d saw customer %d complaining and decided to leave too!\n",
+               actor->customer.id, complaining_pid);
+        leave_restaurant(manager, actor, CONTAGION, LEAVING_EARLY);
+        return true;
+    }
+    return false;
+}
+
+void handle_state(CustomerManager *manager, CustomerActor *actor) {
+    CustomerState state = actor->customer.state;
+
+    // Check for cascade effect while the customer is still in line
+    if (actor->in_queue && state != COMPLAINING && state != FRUSTRATED && state != CONTAGION) {
+        if (check_for_contagion(manager, actor)) {
+            return;
+        }
+    }
+
+    switch (state) {
+        case WALKING:
+            if (!actor->busy) {
+                actor->busy = true;
+                printf("Customer %d is walking...\n", actor->customer.id);
+                schedule(manager, actor, random_int(&actor->rng, 1, 3), CUSTOMER_EV_REACHED_QUEUE);
+            }
+            break;
+
+        case WAITING_IN_QUEUE:
+        case WAITING_FOR_ORDER:
+            // Woken by the seller through the inbox
+            break;
+
+        case ORDERING:
+            if (!actor->busy) {
+                actor->busy = true;
+                printf("Customer %d is ordering...\n", actor->customer.id);
+                schedule(manager, actor, 2, CUSTOMER_EV_ORDER_READY);  // simulate ordering time
+            }
+            break;
+
+        case FRUSTRATED:
+            leave_restaurant(manager, actor, FRUSTRATED, LEAVING_EARLY);
+            break;
+
+        case MISSING_ORDER:
+            printf("Customer %d is missing order\n", actor->customer.id);
+            leave_restaurant(manager, actor, MISSING_ORDER, LEAVING_EARLY);
+            break;
+
+        case COMPLAINING:
+            leave_restaurant(manager, actor, COMPLAINING, LEAVING_EARLY);
+            break;
+
+        case CONTAGION:
+            printf("Customer %d is leaving due to contagion\n", actor->customer.id);
+            leave_restaurant(manager, actor, CONTAGION, LEAVING_EARLY);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Once per CUSTOMER_TICK: patience decay, then one pass of the state machine
+void customer_tick(CustomerManager *manager, CustomerActor *actor) {
+    Customer *customer = &actor->customer;
+
+    if (actor->ticking && customer->state != ORDERING) {
+        customer->patience -= customer->patience_decay;
+
+        // A store into the slot, cheap enough for every tick
+        customer_line_update(manager->customer_line, customer->pid,
+                             customer->state, customer->patience);
+
+        if (customer->patience <= 0) {
+            printf("Customer %d ran out of patience and is leaving\n", customer->id);
+            leave_restaurant(manager, actor, FRUSTRATED, LEAVING_EARLY);
+            return;
+        }
+    }
+
+    handle_state(manager, actor);
+
+    if (actor->active) {
+        schedule(manager, actor, CUSTOMER_TICK, CUSTOMER_EV_TICK);
+    }
+}
+
+void customer_event(CustomerManager *manager, CustomerActor *actor, CustomerEvent event) {
+    switch (event) {
+        case CUSTOMER_EV_TICK:
+            customer_tick(manager, actor);
+            break;
+
+        case CUSTOMER_EV_REACHED_QUEUE:
+            // A seller may have called the customer on the way in
+            if (actor->customer.state == WALKING) {
+                actor->busy = false;
+                update_state(manager, actor, WAITING_IN_QUEUE);
+            }
+            break;
+
+        case CUSTOMER_EV_ORDER_READY: {
+            actor->busy = false;
+
+            // Written once into the arena and posted in the customer's line
+            // slot; the seller takes it from there and frees it
+            ShmRef ref = shm_arena_alloc(manager->arena, sizeof(CustomerOrder));
+            CustomerOrder *order = shm_arena_ptr(manager->arena, ref);
+            if (order == NULL) {
+                fprintf(stderr, "Customer %d: No arena space for the order, retrying\n", actor->customer.id);
+                retry_order(manager, actor);
+                break;
+            }
+            generate_random_customer_order(order, manager->game, &actor->rng);
+
+            if (customer_line_post_order(manager->customer_line, actor->customer.pid, ref) == -1) {
+                shm_arena_free(manager->arena, ref);
+                fprintf(stderr, "Customer %d: Could not post the order, retrying\n", actor->customer.id);
+                retry_order(manager, actor);
+                break;
+            }
+            printf("Customer %d posted order to seller\n", actor->customer.id);
+            update_state(manager, actor, WAITING_FOR_ORDER);
+            break;
+        }
+    }
+}
+
+void customer_seller_message(CustomerManager *manager, CustomerActor *actor, const SellerMessage *msg) {
+    if (msg->notice == SELLER_CALLING) {
+        // The seller took us off the line: stop the patience clock and order
+        actor->ticking = false;
+        actor->in_queue = false;
+        customer_line_called(manager->customer_line, actor->customer.pid);
+        actor->busy = false;
+        actor->customer.patience = actor->original_patience;
+        update_state(manager, actor, ORDERING);
+        handle_state(manager, actor);
+        return;
+    }
+
+    switch (msg->result) {
+        case ORDER_SUCCESS:
+            printf("Customer %d received order successfully, total price: %.2f\n",
+                   actor->customer.id, msg->total_price);
+            leave_restaurant(manager, actor, WAITING_FOR_ORDER, LEAVING_NORMALLY);
+            break;
+
+        case ORDER_MISSING:
+        case ORDER_FAILED:
+            printf("Customer %d's order failed!\n", actor->customer.id);
+            leave_restaurant(manager, actor, MISSING_ORDER, LEAVING_EARLY);
+            break;
+    }
+}
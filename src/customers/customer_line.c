@@ -0,0 +1,453 @@
+//
+// Customer line over the customer queue segment, see customer_line.h.
+//
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "cache_line.h"
+#include "customer_line.h"
+#include "futex_utils.h"
+#include "semaphores_utils.h"
+#include "shared_mem_utils.h"
+
+#define NO_SLOT (-1)
+
+// One lane's FIFO, alone on its cache line(s)
+typedef struct {
+    pthread_mutex_t lock;       // Serialises link changes
+    SeqLock seq;                // Lets graphics walk the links without the lock
+    int head, tail;             // Slots at the front and back, NO_SLOT if empty
+    int waiting;                // Written by the manager only
+    uint32_t joins;             // Futex word, bumped on every join
+    uint32_t sleepers;          // Sellers waiting on joins
+} CACHE_ALIGNED LineLane;
+
+static size_t align_line(size_t size) {
+    return (size + CACHE_LINE - 1) & ~((size_t) CACHE_LINE - 1);
+}
+
+static int line_capacity(const Config *config) {
+    return config->MAX_CUSTOMERS > 0 ? config->MAX_CUSTOMERS : 1;
+}
+
+static int line_lanes(const Config *config) {
+    return config->NUM_SELLERS > 0 ? config->NUM_SELLERS : 1;
+}
+
+static size_t lanes_offset(int capacity) {
+    return align_line(sizeof(CustomerLine) + (size_t) capacity * sizeof(LineSlot));
+}
+
+static LineLane *line_lane(const CustomerLine *line, int lane) {
+    return (LineLane *) ((unsigned char *) line + lanes_offset(line->capacity)) + lane;
+}
+
+static int slot_index(const CustomerLine *line, pid_t key) {
+    return (key - 1) % line->capacity;
+}
+
+static LineSlot *line_slot(CustomerLine *line, pid_t key) {
+    return &line->slots[slot_index(line, key)];
+}
+
+size_t customer_line_size(int capacity, int lanes) {
+    return lanes_offset(capacity) + (size_t) lanes * sizeof(LineLane);
+}
+
+CustomerLine *customer_line_open(const Config *config, int init) {
+    int capacity = line_capacity(config);
+    int lanes = line_lanes(config);
+    size_t size = customer_line_size(capacity, lanes);
+
+    int fd = shm_open(CUSTOMER_QUEUE_SHM_NAME, O_CREAT | O_RDWR, 0666);
+    if (fd == -1) {
+        perror("Failed to open queue shared memory");
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t) size) == -1) {
+        perror("Failed to size queue shared memory");
+        close(fd);
+        return NULL;
+    }
+
+    CustomerLine *line = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (line == MAP_FAILED) {
+        perror("Failed to map queue shared memory");
+        return NULL;
+    }
+
+    if (init) {
+        memset(line, 0, size);
+        line->capacity = capacity;  // Lanes are found through it, see line_lane
+        for (int i = 0; i < capacity; i++) {
+            seqlock_init(&line->slots[i].seq);
+            line->slots[i].prev = line->slots[i].next = NO_SLOT;
+        }
+        for (int i = 0; i < lanes; i++) {
+            LineLane *lane = line_lane(line, i);
+            if (shared_mutex_init(&lane->lock) == -1) {
+                munmap(line, size);
+                return NULL;
+            }
+            seqlock_init(&lane->seq);
+            lane->head = lane->tail = NO_SLOT;
+        }
+        // Publish the lane count last: mappers treat 0 as a line not laid out yet
+        __atomic_store_n(&line->lane_count, lanes, __ATOMIC_RELEASE);
+    }
+    return line;
+}
+
+void customer_line_close(CustomerLine *line, const Config *config) {
+    if (line == NULL) {
+        return;
+    }
+    if (munmap(line, customer_line_size(line_capacity(config), line_lanes(config))) == -1) {
+        perror("munmap failed");
+    }
+}
+
+/* --- lane links, changed with the lane locked ----------------------- */
+
+static void publish_link(int *link, int value) {
+    __atomic_store_n(link, value, __ATOMIC_RELAXED);
+}
+
+static void link_back(CustomerLine *line, LineLane *lane, int index) {
+    LineSlot *slot = &line->slots[index];
+    publish_link(&slot->prev, lane->tail);
+    publish_link(&slot->next, NO_SLOT);
+    if (lane->tail == NO_SLOT) {
+        publish_link(&lane->head, index);
+    } else {
+        publish_link(&line->slots[lane->tail].next, index);
+    }
+    publish_link(&lane->tail, index);
+    slot->queued = 1;
+}
+
+static void unlink_slot(CustomerLine *line, LineLane *lane, int index) {
+    LineSlot *slot = &line->slots[index];
+    if (slot->prev == NO_SLOT) {
+        publish_link(&lane->head, slot->next);
+    } else {
+        publish_link(&line->slots[slot->prev].next, slot->next);
+    }
+    if (slot->next == NO_SLOT) {
+        publish_link(&lane->tail, slot->prev);
+    } else {
+        publish_link(&line->slots[slot->next].prev, slot->prev);
+    }
+    publish_link(&slot->prev, NO_SLOT);
+    publish_link(&slot->next, NO_SLOT);
+    slot->queued = 0;
+}
+
+static int by_arrival(const void *a, const void *b) {
+    return ((const Customer *) a)->id - ((const Customer *) b)->id;
+}
+
+// Whether the customer in slot a came before the one in slot b
+static int arrived_before(const CustomerLine *line, int a, int b) {
+    int id_a = line->slots[a].customer.id, id_b = line->slots[b].customer.id;
+    return id_a < id_b || (id_a == id_b && a < b);
+}
+
+static int queued_in(const LineSlot *slot, int lane_id) {
+    return slot->queued && slot->customer.pid != 0 && slot->customer.seller_id == lane_id;
+}
+
+// Relinking with nothing to sort in: pick the earliest queued slot not
+// linked yet, over and over. Quadratic, but needs no memory.
+static void relink_in_place(CustomerLine *line, LineLane *lane, int lane_id) {
+    lane->head = lane->tail = NO_SLOT;
+    for (int last = NO_SLOT;;) {
+        int next = NO_SLOT;
+        for (int i = 0; i < line->capacity; i++) {
+            if (queued_in(&line->slots[i], lane_id) && (last == NO_SLOT || arrived_before(line, last, i)) &&
+                (next == NO_SLOT || arrived_before(line, i, next))) {
+                next = i;
+            }
+        }
+        if (next == NO_SLOT) {
+            return;
+        }
+        link_back(line, lane, next);
+        last = next;
+    }
+}
+
+// The last holder of the lock died, maybe halfway through relinking: thread
+// the lane's queued slots again in arrival order
+static void repair_lane(CustomerLine *line, LineLane *lane, int lane_id) {
+    Customer *queued = malloc((size_t) line->capacity * sizeof(Customer));
+    if (queued == NULL) {
+        relink_in_place(line, lane, lane_id);
+        return;
+    }
+
+    int count = 0;
+    for (int i = 0; i < line->capacity; i++) {
+        if (queued_in(&line->slots[i], lane_id)) {
+            queued[count++] = line->slots[i].customer;
+        }
+    }
+    qsort(queued, count, sizeof(Customer), by_arrival);
+
+    // Free slots keep their flag, only customers of this lane are relinked
+    lane->head = lane->tail = NO_SLOT;
+    for (int i = 0; i < line->capacity; i++) {
+        if (line->slots[i].customer.pid != 0 && line->slots[i].customer.seller_id == lane_id) {
+            line->slots[i].queued = 0;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        link_back(line, lane, slot_index(line, queued[i].pid));
+    }
+    free(queued);
+}
+
+static void lock_lane(CustomerLine *line, int lane_id) {
+    LineLane *lane = line_lane(line, lane_id);
+    if (shared_mutex_lock(&lane->lock)) {
+        // The sequence may have been left odd too
+        if (__atomic_load_n(&lane->seq.sequence, __ATOMIC_RELAXED) & 1) {
+            seqlock_write_end(&lane->seq);
+        }
+        seqlock_write_begin(&lane->seq);
+        repair_lane(line, lane, lane_id);
+        seqlock_write_end(&lane->seq);
+    }
+    seqlock_write_begin(&lane->seq);
+}
+
+static void unlock_lane(CustomerLine *line, int lane_id) {
+    LineLane *lane = line_lane(line, lane_id);
+    seqlock_write_end(&lane->seq);
+    shared_mutex_unlock(&lane->lock);
+}
+
+/* --- manager side --------------------------------------------------- */
+
+int customer_line_join(CustomerLine *line, const Customer *customer, int lane_id) {
+    LineSlot *slot = line_slot(line, customer->pid);
+    if (slot->customer.pid != 0) {
+        return -1;  // Still held by the slot's previous customer
+    }
+
+    seqlock_write_begin(&slot->seq);
+    slot->customer = *customer;
+    slot->customer.seller_id = (short) lane_id;
+    seqlock_write_end(&slot->seq);
+    __atomic_store_n(&slot->order, 0, __ATOMIC_RELAXED);
+
+    LineLane *lane = line_lane(line, lane_id);
+    lock_lane(line, lane_id);
+    link_back(line, lane, slot_index(line, customer->pid));
+    unlock_lane(line, lane_id);
+    slot->counted = 1;
+    __atomic_add_fetch(&lane->waiting, 1, __ATOMIC_RELAXED);
+
+    // Pairs with the sleepers increment in customer_line_next: either the
+    // seller sees the new joins value, or we see it sleeping and wake it
+    __atomic_add_fetch(&lane->joins, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&lane->sleepers, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&lane->joins, 1);
+    }
+    return 0;
+}
+
+int customer_line_update(CustomerLine *line, pid_t key, CustomerState state, float patience) {
+    LineSlot *slot = line_slot(line, key);
+    if (slot->customer.pid != key) {
+        return -1;
+    }
+
+    seqlock_write_begin(&slot->seq);
+    slot->customer.state = state;
+    slot->customer.patience = patience;
+    seqlock_write_end(&slot->seq);
+    return 0;
+}
+
+// The customer stops counting towards their lane's waiting customers
+static void uncount(CustomerLine *line, LineSlot *slot) {
+    if (slot->counted) {
+        slot->counted = 0;
+        __atomic_sub_fetch(&line_lane(line, slot->customer.seller_id)->waiting, 1, __ATOMIC_RELAXED);
+    }
+}
+
+int customer_line_called(CustomerLine *line, pid_t key) {
+    LineSlot *slot = line_slot(line, key);
+    if (slot->customer.pid != key) {
+        return -1;
+    }
+    uncount(line, slot);
+    return 0;
+}
+
+int customer_line_leave(CustomerLine *line, pid_t key) {
+    LineSlot *slot = line_slot(line, key);
+    if (slot->customer.pid != key) {
+        return -1;
+    }
+
+    int lane_id = slot->customer.seller_id;
+    lock_lane(line, lane_id);
+    if (slot->queued) {
+        unlink_slot(line, line_lane(line, lane_id), slot_index(line, key));
+    }
+    unlock_lane(line, lane_id);
+    uncount(line, slot);
+
+    // A seller holding the key finds the slot moved on from here
+    __atomic_store_n(&slot->order, 0, __ATOMIC_RELAXED);
+    seqlock_write_begin(&slot->seq);
+    slot->customer.pid = 0;
+    seqlock_write_end(&slot->seq);
+    return 0;
+}
+
+int customer_line_post_order(CustomerLine *line, pid_t key, ShmRef order) {
+    LineSlot *slot = line_slot(line, key);
+    if (slot->customer.pid != key) {
+        return -1;
+    }
+    // Tagged with the key, so the seller never takes another customer's order
+    __atomic_store_n(&slot->order, (uint64_t) (uint32_t) key << 32 | order, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int customer_line_waiting(const CustomerLine *line, int lane) {
+    return __atomic_load_n(&line_lane(line, lane)->waiting, __ATOMIC_RELAXED);
+}
+
+/* --- seller side ---------------------------------------------------- */
+
+// Unlink the front customer of a lane and copy them out; -1 if it is empty
+static int take_front(CustomerLine *line, int lane_id, Customer *customer) {
+    LineLane *lane = line_lane(line, lane_id);
+    if (__atomic_load_n(&lane->head, __ATOMIC_RELAXED) == NO_SLOT) {
+        return -1;  // Skip the lock for the common empty lane
+    }
+
+    lock_lane(line, lane_id);
+    int index = lane->head;
+    if (index != NO_SLOT) {
+        unlink_slot(line, lane, index);
+        seqlock_read_copy(&line->slots[index].seq, customer, &line->slots[index].customer, sizeof(Customer));
+    }
+    unlock_lane(line, lane_id);
+    return index == NO_SLOT ? -1 : 0;
+}
+
+static double timespec_seconds(const struct timespec *ts) {
+    return (double) ts->tv_sec + (double) ts->tv_nsec / 1e9;
+}
+
+int customer_line_next(CustomerLine *line, int lane, Customer *customer, const struct timespec *timeout) {
+    int lanes = __atomic_load_n(&line->lane_count, __ATOMIC_ACQUIRE);
+    if (lanes == 0) {
+        nanosleep(timeout, NULL);  // The manager has not laid the line out yet
+        return -1;
+    }
+    lane %= lanes;
+
+    LineLane *own = line_lane(line, lane);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double deadline = timespec_seconds(&now) + timespec_seconds(timeout);
+
+    for (;;) {
+        uint32_t seen = __atomic_load_n(&own->joins, __ATOMIC_SEQ_CST);
+
+        // Own lane first, then whatever the other lanes' sellers have not got to
+        for (int i = 0; i < lanes; i++) {
+            if (take_front(line, (lane + i) % lanes, customer) == 0) {
+                return 0;
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double left = deadline - timespec_seconds(&now);
+        if (left <= 0) {
+            return -1;
+        }
+        struct timespec wait = {.tv_sec = (time_t) left};
+        wait.tv_nsec = (long) ((left - (double) wait.tv_sec) * 1e9);
+
+        // Sleeps only if nobody joined the lane since seen was read
+        __atomic_add_fetch(&own->sleepers, 1, __ATOMIC_SEQ_CST);
+        int result = futex_wait_timeout(&own->joins, seen, &wait);
+        __atomic_sub_fetch(&own->sleepers, 1, __ATOMIC_SEQ_CST);
+        if (result == -1) {
+            return -1;
+        }
+    }
+}
+
+int customer_line_take_order(CustomerLine *line, pid_t key, ShmRef *order) {
+    LineSlot *slot = line_slot(line, key);
+    uint64_t posted = __atomic_load_n(&slot->order, __ATOMIC_ACQUIRE);
+
+    if (posted >> 32 == (uint32_t) key &&
+        __atomic_compare_exchange_n(&slot->order, &posted, 0, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        *order = (ShmRef) posted;
+        return 1;
+    }
+    // The slot no longer holds this customer: they left without ordering
+    return customer_line_present(line, key) ? 0 : -1;
+}
+
+int customer_line_present(CustomerLine *line, pid_t key) {
+    // A later customer in the slot has a key of a later generation
+    return __atomic_load_n(&line_slot(line, key)->customer.pid, __ATOMIC_RELAXED) == key;
+}
+
+/* --- graphics side -------------------------------------------------- */
+
+int customer_line_lane_snapshot(const CustomerLine *line, int lane_id, Customer *customers, int max) {
+    if (lane_id >= __atomic_load_n(&line->lane_count, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    const LineLane *lane = line_lane(line, lane_id);
+    int count;
+    uint32_t start;
+
+    do {
+        start = seqlock_read_begin(&lane->seq);
+        count = 0;
+        // A walk racing a relink may see any links; bound it and let the
+        // sequence check throw it away
+        int index = __atomic_load_n(&lane->head, __ATOMIC_RELAXED);
+        for (int steps = 0; index >= 0 && index < line->capacity && steps < line->capacity && count < max; steps++) {
+            const LineSlot *slot = &line->slots[index];
+            seqlock_read_copy(&slot->seq, &customers[count], &slot->customer, sizeof(Customer));
+            if (customers[count].pid != 0) {
+                count++;
+            }
+            index = __atomic_load_n(&slot->next, __ATOMIC_RELAXED);
+        }
+    } while (seqlock_read_retry(&lane->seq, start));
+    return count;
+}
+
+int customer_line_snapshot(const CustomerLine *line, Customer *customers, int max) {
+    int lanes = __atomic_load_n(&line->lane_count, __ATOMIC_ACQUIRE);
+    int count = 0;
+
+    for (int i = 0; i < lanes && count < max; i++) {
+        count += customer_line_lane_snapshot(line, i, customers + count, max - count);
+    }
+
+    // Ids are handed out in arrival order; each lane already is
+    qsort(customers, count, sizeof(Customer), by_arrival);
+    return count;
+}
@@ -0,0 +1,297 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ipc.h>
+#include <sys/msg.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include "customer_manager.h"
+#include "customer.h"
+#include "random.h"
+#include "semaphores_utils.h"
+#include "shared_mem_utils.h"
+#include "event_queue.h"
+
+int init_customer_manager(CustomerManager *manager, Game *game) {
+    manager->game = game;
+    manager->active_customers = 0;
+    manager->next_customer_id = 0;
+    manager->capacity = game->config.MAX_CUSTOMERS > 0 ? game->config.MAX_CUSTOMERS : 1;
+    manager->now = sim_now(&game->clock);
+    manager->next_arrival = manager->now;
+    random_stream_init(&manager->rng, game->config.SEED, RANDOM_CUSTOMER_MANAGER, 0);
+
+    manager->actors = calloc(manager->capacity, sizeof(CustomerActor));
+    manager->free_slots = malloc(manager->capacity * sizeof(int));
+    if (manager->actors == NULL || manager->free_slots == NULL) {
+        perror("Failed to allocate customer actors");
+        return -1;
+    }
+    // Pushed backwards so the first customers take the first slots
+    manager->free_count = 0;
+    for (int i = manager->capacity - 1; i >= 0; i--) {
+        manager->free_slots[manager->free_count++] = i;
+    }
+    if (event_queue_init(&manager->events, 2 * manager->capacity) == -1) {
+        return -1;
+    }
+
+    // Lay out the customer line the sellers take customers from
+    manager->customer_line = customer_line_open(&game->config, 1);
+    if (manager->customer_line == NULL) {
+        return -1;
+    }
+
+    manager->arena = shm_arena_map(BAKERY_ARENA_SHM_NAME);
+    if (manager->arena == NULL) {
+        return -1;
+    }
+
+    // Create named semaphore for complaint synchronization
+    manager->complaint_sem = sem_open(COMPLAINT_SEM_NAME, O_CREAT, 0666, 1);
+    if (manager->complaint_sem == SEM_FAILED) {
+        perror("Failed to create complaint semaphore");
+        return -1;
+    }
+
+    manager->inbox_queue_id = get_customer_inbox_queue();
+    if (manager->inbox_queue_id == -1) {
+        return -1;
+    }
+
+    printf("Customer Manager started. Inbox queue ID: %d\n", manager->inbox_queue_id);
+    return 0;
+}
+
+void cleanup_customer_manager(CustomerManager *manager) {
+    printf("Cleaning up resources...in customer_manager\n");
+    if (manager->inbox_queue_id > 0) {
+        msgctl(manager->inbox_queue_id, IPC_RMID, NULL);
+        manager->inbox_queue_id = -1;
+    }
+
+    if (manager->customer_line != NULL) {
+        printf("cleaning up queue...\n");
+        customer_line_close(manager->customer_line, &manager->game->config);
+        shm_unlink(CUSTOMER_QUEUE_SHM_NAME);
+        manager->customer_line = NULL;
+    }
+
+    if (manager->arena != NULL) {
+        shm_arena_unmap(manager->arena);
+        manager->arena = NULL;
+    }
+
+    if (manager->actors != NULL) {
+        event_queue_destroy(&manager->events);
+        free(manager->actors);
+        manager->actors = NULL;
+    }
+    free(manager->free_slots);
+    manager->free_slots = NULL;
+
+    // Clean up named semaphores
+    if (manager->complaint_sem != NULL && manager->complaint_sem != SEM_FAILED) {
+        sem_close(manager->complaint_sem);
+        sem_unlink(COMPLAINT_SEM_NAME);
+        manager->complaint_sem = NULL;
+    }
+}
+
+// Deliver every pending seller notice to its customer
+void process_seller_messages(CustomerManager *manager) {
+    SellerMessage msg;
+
+    while (msgrcv(manager->inbox_queue_id, &msg, sizeof(SellerMessage) - sizeof(long), 0, IPC_NOWAIT) != -1) {
+        int slot = (int) ((msg.mtype - 1) % manager->capacity);
+        CustomerActor *actor = &manager->actors[slot];
+
+        // Notices for a customer who already left are dropped; the seller
+        // finds their line slot moved on
+        if (actor->active && actor->customer.pid == msg.mtype) {
+            customer_seller_message(manager, actor, &msg);
+        }
+    }
+}
+
+void check_and_reset_complaints(CustomerManager *manager) {
+    Game *game = manager->game;
+
+    sem_wait(manager->complaint_sem);
+
+    if (game->recent_complaint) {
+        // Reset complaint after CASCADE_WINDOW seconds
+        if (manager->now - game->last_complaint_time > game->config.CASCADE_WINDOW) {
+            game->recent_complaint = false;
+            printf("Complaint effect has expired\n");
+        }
+    }
+
+    sem_post(manager->complaint_sem);
+}
+
+// Customers the seller is already serving count towards its lane
+static int lane_load(CustomerManager *manager, int lane) {
+    int load = customer_line_waiting(manager->customer_line, lane);
+    if (lane < manager->game->layout.seller_slots) {
+        load += __atomic_load_n(&game_seller(manager->game, lane)->serving, __ATOMIC_RELAXED);
+    }
+    return load;
+}
+
+// Power of two choices: the customer looks at two random lanes and joins
+// the shorter one
+static int choose_lane(CustomerManager *manager, RandomStream *rng) {
+    int lanes = manager->customer_line->lane_count;
+    if (lanes == 1) {
+        return 0;
+    }
+    int first = random_below(rng, lanes);
+    int second = random_below(rng, lanes - 1);
+    if (second >= first) {
+        second++;
+    }
+    return lane_load(manager, second) < lane_load(manager, first) ? second : first;
+}
+
+void spawn_customer(CustomerManager *manager) {
+    Game *game = manager->game;
+
+    if (manager->active_customers >= game->config.MAX_CUSTOMERS || manager->free_count == 0) {
+        return; // Don't spawn if we're at max capacity
+    }
+
+    // The key maps back to the slot, and the slot's generation keeps keys of
+    // earlier customers in it (still in a lane ring, say) from matching
+    int slot = manager->free_slots[--manager->free_count];
+    int customer_id = manager->next_customer_id++;
+    CustomerActor *actor = &manager->actors[slot];
+    Customer *customer = &actor->customer;
+
+    // Create a new customer with random attributes
+    random_stream_init(&actor->rng, game->config.SEED, RANDOM_CUSTOMER, customer_id);
+    create_random_customer(customer, &game->config, &actor->rng);
+    customer->id = customer_id;
+    customer->pid = actor->generation * manager->capacity + slot + 1;
+    customer->state = WALKING;
+
+    actor->original_patience = customer->patience;
+    actor->in_queue = true;
+    actor->ticking = true;
+    actor->busy = false;
+
+    int lane = choose_lane(manager, &actor->rng);
+    customer->seller_id = (short) lane;
+    if (customer_line_join(manager->customer_line, customer, lane) == -1) {
+        printf("Failed to add customer to queue\n");
+        manager->free_slots[manager->free_count++] = slot;
+        return;
+    }
+
+    actor->active = true;
+    manager->active_customers++;
+    printf("Spawned customer %d\n", customer_id);
+
+    // First step right away, then once per CUSTOMER_TICK
+    event_queue_push(&manager->events, manager->now, CUSTOMER_EV_TICK,
+                     slot, actor->generation);
+}
+
+double customer_manager_step(CustomerManager *manager, double now) {
+    Game *game = manager->game;
+    SimEvent event;
+
+    manager->now = now;
+
+    // Arrivals, complaint expiry and statistics once per simulated second
+    if (now >= manager->next_arrival) {
+        if (random_float(&manager->rng, 0, 1) < game->config.CUSTOMER_PROBABILITY) {
+            spawn_customer(manager);
+        }
+
+        check_and_reset_complaints(manager);
+
+        printf("Active: %d, Frustrated: %d, Complained: %d, Missing: %d, Cascade: %d\n",
+               manager->active_customers,
+               (int) stats_read(&game->stats, STAT_FRUSTRATED),
+               (int) stats_read(&game->stats, STAT_COMPLAINED),
+               (int) stats_read(&game->stats, STAT_MISSING),
+               (int) stats_read(&game->stats, STAT_CASCADE));
+
+        manager->next_arrival += 1;
+        if (manager->next_arrival <= now) {
+            manager->next_arrival = now + 1;
+        }
+    }
+
+    process_seller_messages(manager);
+
+    // Run every customer event that is due
+    while (event_queue_peek(&manager->events, &event) == 0 && event.time <= now) {
+        event_queue_pop(&manager->events, &event);
+
+        CustomerActor *actor = &manager->actors[event.actor];
+        if (!actor->active || actor->generation != event.data) {
+            continue;  // The customer left since this was scheduled
+        }
+
+        manager->now = event.time;
+        customer_event(manager, actor, (CustomerEvent) event.type);
+    }
+    manager->now = now;
+
+    double next = manager->next_arrival;
+    if (event_queue_peek(&manager->events, &event) == 0 && event.time < next) {
+        next = event.time;
+    }
+    return next;
+}
+
+void run_customer_manager(CustomerManager *manager) {
+    Game *game = manager->game;
+
+    while (!__atomic_load_n(&game->game_over, __ATOMIC_ACQUIRE)) {
+        double now = sim_now(&game->clock);
+        double next = customer_manager_step(manager, now);
+
+        // Seller messages are polled, so never sleep past 100 ms
+        double wait = next - now;
+        if (wait > 0.1) {
+            wait = 0.1;
+        }
+        if (wait > 0) {
+            sim_sleep(&game->clock, wait);
+        }
+        fflush(stdout);
+    }
+}
+
+void handle_customer_state(CustomerManager *manager, CustomerState state, pid_t key) {
+    Game *game = manager->game;
+
+    switch (state) {
+        case FRUSTRATED:
+            stats_add(&game->stats, STAT_FRUSTRATED, 1);
+            break;
+
+        case COMPLAINING: {
+            stats_add(&game->stats, STAT_COMPLAINED, 1);
+            game->complaining_customer_pid = key;
+            game->last_complaint_time = (int) manager->now;
+            game->recent_complaint = true;
+            break;
+        }
+        case MISSING_ORDER:
+            stats_add(&game->stats, STAT_MISSING, 1);
+            break;
+        case CONTAGION:
+            stats_add(&game->stats, STAT_CASCADE, 1);
+            break;
+        default:
+            break;
+    }
+
+    // Let main know if this departure ended the game
+    notify_game_state(game);
+}
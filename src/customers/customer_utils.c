@@ -8,12 +8,12 @@
 #include "random.h"
 #include "queue.h"
 
-void create_random_customer(Customer *customer, Config *config) {
+void create_random_customer(Customer *customer, Config *config, RandomStream *rng) {
 
     if (!customer)
         return;
-    customer->patience = random_float(config->MIN_PATIENCE, config->MAX_PATIENCE);
-    customer->patience_decay = random_float(config->MIN_PATIENCE_DECAY, config->MAX_PATIENCE_DECAY);
+    customer->patience = random_float(rng, config->MIN_PATIENCE, config->MAX_PATIENCE);
+    customer->patience_decay = random_float(rng, config->MIN_PATIENCE_DECAY, config->MAX_PATIENCE_DECAY);
     customer->has_complained = false;
     customer->state = WALKING;
 }
@@ -45,44 +45,52 @@ void print_customer(Customer *customer) {
 }
 
 
-void generate_random_customer_order(CustomerOrder *order, Game *game) {
+void generate_random_customer_order(CustomerOrder *order, Game *game, RandomStream *rng) {
 
     order->item_count = 0;
     order->total_price = 0;
 
-    int num_items = (int) random_float(game->config.MIN_ORDER_ITEMS, game->config.MAX_ORDER_ITEMS);  // Order 1-3 items
+    int num_items = (int) random_float(rng, game->config.MIN_ORDER_ITEMS, game->config.MAX_ORDER_ITEMS);  // Order 1-3 items
+    if (num_items > MAX_ORDER_ITEMS_) {
+        num_items = MAX_ORDER_ITEMS_;
+    }
+
+    // Draw the product picks and quantities for the whole order at once
+    float product_picks[MAX_ORDER_ITEMS_];
+    float quantities[MAX_ORDER_ITEMS_];
+    random_fill_float(rng, product_picks, num_items, 0, 1);
+    random_fill_float(rng, quantities, num_items, game->config.MIN_PURCHASE_QUANTITY,
+                      game->config.MAX_PURCHASE_QUANTITY);
 
     // Generate each item in the order
     for (int i = 0; i < num_items ; i++) {
-        // Get the product catalog
-        ProductCatalog *catalog = &game->productCatalog;
+        // The catalog categories are laid out in the game
+        int category_count = game->layout.category_count;
 
         // Pick a random category with products
         int attempts = 0;
-        ProductCategory *category;
+        int category;
         do {
 
             // Pick a random category
-            int random_category = rand() % catalog->category_count;
-            category = &catalog->categories[random_category];
-            if (++attempts > catalog->category_count * 2) {
+            category = random_below(rng, category_count);
+            if (++attempts > category_count * 2) {
                 break;  // Avoid infinite loop
             }
-        } while (category->product_count <= 0);
+        } while (game_product_count(game, category) <= 0);
 
-        if (category->product_count <= 0) {
+        if (game_product_count(game, category) <= 0) {
             continue;  // Skip if no products in category
         }
 
         // Pick a random product from the category
-        int random_product = rand() % category->product_count;
+        int random_product = (int) ((double) product_picks[i] * game_product_count(game, category));
 
         // Add to order with a quantity between 1-3
-        order->items[order->item_count].product = category->products[random_product];
-        order->items[order->item_count].quantity = (int) random_float(game->config.MIN_PURCHASE_QUANTITY,
-                                                              game->config.MAX_PURCHASE_QUANTITY);
+        order->items[order->item_count].product = *game_product(game, category, random_product);
+        order->items[order->item_count].quantity = (int) quantities[i];
 
-        order->items[order->item_count].type = category->type;
+        order->items[order->item_count].type = game->layout.categories[category].type;
         order->items[order->item_count].product_index = random_product;
 
         // Calculate price for this item
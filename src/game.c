@@ -10,23 +10,83 @@
 #include "config.h"
 #include "unistd.h"
 #include <string.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include "shared_mem_utils.h"
+#include "futex_utils.h"
+
+// Zeroed heap Game for the headless runners, aligned like the shm mapping
+Game *game_alloc(const Config *config, const ProductCatalog *catalog) {
+    size_t size = game_size(config, catalog);
+    void *memory;
+    if (posix_memalign(&memory, CACHE_LINE, size) != 0) {
+        perror("Failed to allocate game");
+        return NULL;
+    }
+    memset(memory, 0, size);
+    game_layout(memory, config, catalog);
+    return memory;
+}
 
+// Ready products are counted by product type, orders carry the type
+int game_reset_ready_products(Game *game) {
+    int counts[NUM_PRODUCTS] = {0};
+    for (int i = 0; i < game->layout.category_count; i++) {
+        ProductType type = game->layout.categories[i].type;
+        if (type >= 0 && type < NUM_PRODUCTS && counts[type] == 0) {
+            counts[type] = game_product_count(game, i);
+        }
+    }
+    return init_ready_products(&game->ready_products, game_ready_quantities(game), counts);
+}
 
-int game_init(Game *game, pid_t *processes, pid_t *processes_sellers, int shared_mem_fd) {
-
+// Resets counters, inventory, ovens and the oven timer wheel
+int game_reset(Game *game) {
     game->elapsed_time = 0;
-    game->num_frustrated_customers = 0;
-    game->num_complained_customers = 0;
-    game->num_customers_missing = 0;
-    game->num_customers_served = 0;
-    game->num_customers_cascade = 0;
-    game->daily_profit = 0.0f;
+    stats_reset(&game->stats);
     game->complaining_customer_pid = 0;
     game->recent_complaint = false;
+    game->game_over = 0;
     init_inventory(&game->inventory);
+    if (game_reset_ready_products(game) == -1) {
+        return -1;
+    }
+
+    for (int i = 0; i < game->layout.oven_slots; i++) {
+        Oven *oven = game_oven(game, i);
+        seqlock_init(&oven->seq);
+        oven->id = i;
+        oven->is_busy = 0;
+    }
+    TimerEntry *timers = (TimerEntry *) ((char *) game + game->layout.oven_timers);
+    if (timer_wheel_init(&game->oven_timers, timers, game->layout.oven_slots) == -1) {
+        return -1;
+    }
+    return 0;
+}
 
+// Sellers map the game segment by name and take their index instead
+static pid_t start_seller(int id) {
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork");
+        exit(EXIT_FAILURE);
+    }
+
+    if (pid == 0) {
+        char id_str[12];
+        snprintf(id_str, sizeof(id_str), "%d", id);
+        execl("./sellers", "./sellers", id_str, NULL);
+        perror("execl failed");
+        exit(EXIT_FAILURE);
+    }
+    return pid;
+}
+
+int game_init(Game *game, pid_t *processes, pid_t *processes_sellers, int shared_mem_fd) {
+    if (game_reset(game) == -1) {
+        return -1;
+    }
 
     char *binary_paths[] = {
         "./graphics",
@@ -44,13 +104,12 @@ int game_init(Game *game, pid_t *processes, pid_t *processes_sellers, int shared
         processes[i] = start_process(binary_paths[i], shared_mem_fd, suppress);
     }
     
-    char *seller = "./sellers";
-    //
-    // for (int i = 0; i < game->config.NUM_SELLERS; i++) {
-    //     processes_sellers[i] = start_process(seller, 0, false);
-    //     game->info.sellers[i].id = i;
-    //     game->info.sellers[i].pid = processes_sellers[i];
-    // }
+    // One seller per lane of the customer line
+    for (int i = 0; i < game->config.NUM_SELLERS; i++) {
+        processes_sellers[i] = start_seller(i);
+        game_seller(game, i)->id = i;
+        game_seller(game, i)->pid = processes_sellers[i];
+    }
 
     return 0;
 }
@@ -88,17 +147,80 @@ int check_game_conditions(const Game *game) {
     if (game->elapsed_time > game->config.MAX_TIME) {
         return 0;
     }
-    if (game->num_frustrated_customers >= game->config.FRUSTRATED_CUSTOMERS) {
+    if (stats_read(&game->stats, STAT_FRUSTRATED) >= game->config.FRUSTRATED_CUSTOMERS) {
         return 0;
     }
-    if (game->num_complained_customers >= game->config.COMPLAINED_CUSTOMERS) {
+    if (stats_read(&game->stats, STAT_COMPLAINED) >= game->config.COMPLAINED_CUSTOMERS) {
         return 0;
     }
-    if (game->num_customers_missing >= game->config.CUSTOMERS_MISSING) {
+    if (stats_read(&game->stats, STAT_MISSING) >= game->config.CUSTOMERS_MISSING) {
         return 0;
     }
-    if (game->daily_profit > game->config.DAILY_PROFIT) {
+    if (stats_profit(&game->stats) > game->config.DAILY_PROFIT) {
         return 0;
     }
     return 1;
-}
\ No newline at end of file
+}
+
+// Called by whoever updates the counters; wakes main once the game has ended
+void notify_game_state(Game *game) {
+    if (check_game_conditions(game)) {
+        return;
+    }
+
+    if (__atomic_exchange_n(&game->game_over, 1, __ATOMIC_ACQ_REL) == 0) {
+        futex_wake(&game->game_over, INT32_MAX);
+    }
+}
+
+// Block until notify_game_state flags the end of the game
+void wait_for_game_over(Game *game) {
+    while (__atomic_load_n(&game->game_over, __ATOMIC_ACQUIRE) == 0) {
+        futex_wait(&game->game_over, 0);
+    }
+}
+
+// Oven completion, fired by the timer wheel
+static void finish_oven(int oven_id, void *context) {
+    Game *game = context;
+    Oven *oven = game_oven(game, oven_id);
+
+    printf("[main] Oven %d finished baking %s (team %s)\n",
+           oven->id, oven->item_name, oven->team_name);
+
+    seqlock_write_begin(&oven->seq);
+    oven->item_name[0] = '\0';
+    oven->team_name[0] = '\0';
+    oven->time_left = 0;
+    seqlock_write_end(&oven->seq);
+
+    // Hand the oven back and wake the baker waiting on it
+    __atomic_store_n(&oven->is_busy, 0, __ATOMIC_RELEASE);
+    futex_wake((uint32_t *) &oven->is_busy, INT32_MAX);
+}
+
+// Clock thread: turns the oven timer wheel and keeps elapsed_time in step
+void *run_game_clock(void *arg) {
+    Game *game = arg;
+
+    while (!__atomic_load_n(&game->game_over, __ATOMIC_ACQUIRE)) {
+        sim_sleep(&game->clock, TIMER_WHEEL_TICK);
+
+        double now = sim_now(&game->clock);
+        timer_wheel_advance(&game->oven_timers, now, finish_oven, game);
+
+        if ((int) now != game->elapsed_time) {
+            game->elapsed_time = (int) now;
+            notify_game_state(game);  // Wakes main at MAX_TIME
+        }
+        fflush(stdout);
+    }
+
+    // No more ticks: hand back every busy oven so no baker waits forever
+    for (int i = 0; i < game->layout.oven_slots; i++) {
+        if (timer_wheel_cancel(&game->oven_timers, i) == 0) {
+            finish_oven(i, game);
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,63 @@
+//
+// Where the per-actor slot arrays go in the game segment, see GameLayout.
+// Kept apart from game.c so every process mapping the segment can link it.
+//
+
+#include "game.h"
+
+static size_t align_line(size_t offset) {
+    return (offset + CACHE_LINE - 1) & ~((size_t) CACHE_LINE - 1);
+}
+
+static int slot_count(int configured) {
+    return configured > 0 ? configured : 0;
+}
+
+// Slot arrays in the order they follow the fixed part; size is the end
+static GameLayout plan_layout(const Config *config, const ProductCatalog *catalog) {
+    GameLayout layout = {.magic = GAME_LAYOUT_MAGIC, .version = GAME_LAYOUT_VERSION};
+    layout.chef_slots = slot_count(config->NUM_CHEFS);
+    layout.baker_slots = slot_count(config->NUM_BAKERS);
+    // The headless simulation runs one seller even when none are configured
+    layout.seller_slots = config->NUM_SELLERS > 1 ? config->NUM_SELLERS : 1;
+    // Ovens double as timer ids in the oven timer wheel, one timer each
+    layout.oven_slots = slot_count(config->NUM_OVENS);
+    // Categories keep their catalog index, the chef teams go by it
+    if (catalog != NULL) {
+        layout.category_count = catalog->category_count;
+        for (int i = 0; i < catalog->category_count; i++) {
+            layout.categories[i].type = catalog->categories[i].type;
+            layout.categories[i].first = layout.product_slots;
+            layout.categories[i].product_count = catalog->categories[i].product_count;
+            layout.product_slots += catalog->categories[i].product_count;
+        }
+    }
+
+    layout.chefs = align_line(sizeof(Game));
+    layout.bakers = align_line(layout.chefs + (size_t) layout.chef_slots * sizeof(Chef));
+    layout.sellers = align_line(layout.bakers + (size_t) layout.baker_slots * sizeof(Baker));
+    layout.ovens = align_line(layout.sellers + (size_t) layout.seller_slots * sizeof(Seller));
+    layout.oven_timers = align_line(layout.ovens + (size_t) layout.oven_slots * sizeof(Oven));
+    layout.products = align_line(layout.oven_timers + (size_t) layout.oven_slots * sizeof(TimerEntry));
+    layout.ready = align_line(layout.products + (size_t) layout.product_slots * sizeof(Product));
+    layout.size = align_line(layout.ready + (size_t) layout.product_slots * sizeof(int));
+    return layout;
+}
+
+size_t game_size(const Config *config, const ProductCatalog *catalog) {
+    return plan_layout(config, catalog).size;
+}
+
+void game_layout(Game *game, const Config *config, const ProductCatalog *catalog) {
+    game->config = *config;
+    game->layout = plan_layout(config, catalog);
+    for (int i = 0; i < game->layout.category_count; i++) {
+        for (int j = 0; j < game_product_count(game, i); j++) {
+            *game_product(game, i, j) = catalog->categories[i].products[j];
+        }
+    }
+}
+
+int game_layout_valid(const Game *game) {
+    return game->layout.magic == GAME_LAYOUT_MAGIC && game->layout.version == GAME_LAYOUT_VERSION;
+}
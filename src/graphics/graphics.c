@@ -11,8 +11,8 @@
  #include "game.h"
  #include "inventory.h"
  #include "products.h"
- #include "queue.h"
  #include "customer.h"
+ #include "customer_line.h"
  #include "shared_mem_utils.h"
  
  #include <fcntl.h>
@@ -21,6 +21,7 @@
  #include <stdlib.h>
  #include <stdio.h>
  #include <string.h>
+ #include <math.h>
  
  /* ---------- helper: readable baker team -------------------- */
  static const char* get_team_name_str(Team t){
@@ -99,7 +100,7 @@
  
  /* ---------- leaver tracking -------------------------------- */
  typedef struct{
-     const Customer *ref;
+     pid_t key;
      Animation *anim;
      float x,y,dx,dy;
      bool active;
@@ -115,8 +116,16 @@
  {
      /* ---- shared memory ------------------------------------ */
      Game *g=NULL;          setup_shared_memory(&g);
-     queue_shm *custQ=NULL; setup_queue_shared_memory(&custQ,
-                                        g->config.MAX_CUSTOMERS);
+     CustomerLine *custQ=customer_line_open(&g->config,0);
+     if(!custQ) return 1;
+     int lineCap=g->config.MAX_CUSTOMERS>0?g->config.MAX_CUSTOMERS:1;
+     Customer *line=malloc(lineCap*sizeof(Customer));
+     /* per-frame staff copies, as many as the segment has slots */
+     Baker *bakers=NULL; Chef *chefs=NULL;
+     if(posix_memalign((void**)&bakers,CACHE_LINE,(g->layout.baker_slots+1)*sizeof(Baker)) ||
+        posix_memalign((void**)&chefs,CACHE_LINE,(g->layout.chef_slots+1)*sizeof(Chef))) return 1;
+     int *ready=malloc((g->ready_products.product_slots+1)*sizeof(int));
+     if(!ready) return 1;
  
      /* ---- assets ------------------------------------------- */
      InitWindow(WIN_W,WIN_H,"Bakery GUI");
@@ -157,12 +166,17 @@
          float dt=GetFrameTime();
  
          /* live counts & pointers ----------------------------- */
-         int nBakers = g->config.NUM_BAKERS;
-         int nChefs  = g->config.NUM_CHEFS;
+         int nBakers = g->layout.baker_slots;
+         int nChefs  = g->layout.chef_slots;
          int nSell   = g->config.NUM_SELLERS;
  
-         Baker *bakers = g->info.bakers;
-         Chef  *chefs  = g->info.chefs;
+         /* consistent per-frame copies, the workers never wait on us;
+            bounded, since a killed worker leaves its slot mid-update */
+         for(int i=0;i<nBakers;i++)
+             seqlock_read_copy_bounded(&game_baker(g,i)->seq,&bakers[i],game_baker(g,i),sizeof(Baker));
+         for(int i=0;i<nChefs;i++)
+             seqlock_read_copy_bounded(&game_chef(g,i)->seq,&chefs[i],game_chef(g,i),sizeof(Chef));
+         snapshot_ready_products(&g->ready_products,ready);
  
          /* camera -------------------------------------------- */
          if(IsKeyDown(KEY_RIGHT)) cam.target.x += 8;
@@ -203,22 +217,22 @@
              }
  
              /* queue customers */
-             int qN = custQ->count>MAX_VISUALS?MAX_VISUALS:custQ->count;
+             int qN = customer_line_snapshot(custQ,line,lineCap);
+             if(qN>MAX_VISUALS) qN=MAX_VISUALS;
              for(int i=0;i<qN;i++){
-                 int qi=(custQ->head+i)%custQ->capacity;
-                 Customer *c=&((Customer*)custQ->elements)[qi];
+                 Customer *c=&line[i];
  
                  /* frustrated → leaver ------------------------- */
                  if(c->state==FRUSTRATED){
                      int slot=-1;
                      for(int l=0;l<MAX_LEAVERS;l++){
-                         if(leavers[l].active && leavers[l].ref==c){ slot=-2; break;}
+                         if(leavers[l].active && leavers[l].key==c->pid){ slot=-2; break;}
                          if(!leavers[l].active && slot==-1) slot=l;
                      }
                      if(slot>=0){
                          float sx=sp-SELL_W/2-60-i*QUEUE_SPACING;
                          leavers[slot]=(Leaver){
-                             .ref=c,.x=sx,.y=groundY-16,.active=true,
+                             .key=c->pid,.x=sx,.y=groundY-16,.active=true,
                              .anim=CreateAnimation(sheet,(Rectangle*)frustFrames,4,12)};
                          Vector2 dir=Vector2Normalize((Vector2){EXIT_X-sx,EXIT_Y-(groundY-16)});
                          leavers[slot].dx=dir.x; leavers[slot].dy=dir.y;
@@ -265,15 +279,15 @@
          DrawRectangle(rx,0,DASH_W,WIN_H,(Color){245,245,245,255});
          DrawText("Game Dashboard",rx+10,10,FONT_LG,DARKGRAY);
          DrawText(TextFormat("Time  : %d s",g->elapsed_time),rx+10,50,FONT_MD,BLACK);
-         DrawText(TextFormat("Profit: %.2f",g->daily_profit),rx+10,70,FONT_MD,BLACK);
+         DrawText(TextFormat("Profit: %.2f",stats_profit(&g->stats)),rx+10,70,FONT_MD,BLACK);
  
          int y=100;
          DrawText("Customers:",rx+10,y,FONT_MD,DARKGRAY); y+=20;
-         DrawText(TextFormat("Served        : %d",g->num_customers_served),rx+10,y,FONT_XS,BLACK); y+=14;
-         DrawText(TextFormat("Frustrated    : %d",g->num_frustrated_customers),rx+10,y,FONT_XS,BLACK); y+=14;
-         DrawText(TextFormat("Complained    : %d",g->num_complained_customers),rx+10,y,FONT_XS,BLACK); y+=14;
-         DrawText(TextFormat("Missing Item  : %d",g->num_customers_missing),rx+10,y,FONT_XS,BLACK); y+=14;
-         DrawText(TextFormat("Cascade Events: %d",g->num_customers_cascade),rx+10,y,FONT_XS,BLACK); y+=20;
+         DrawText(TextFormat("Served        : %d",(int)stats_read(&g->stats,STAT_SERVED)),rx+10,y,FONT_XS,BLACK); y+=14;
+         DrawText(TextFormat("Frustrated    : %d",(int)stats_read(&g->stats,STAT_FRUSTRATED)),rx+10,y,FONT_XS,BLACK); y+=14;
+         DrawText(TextFormat("Complained    : %d",(int)stats_read(&g->stats,STAT_COMPLAINED)),rx+10,y,FONT_XS,BLACK); y+=14;
+         DrawText(TextFormat("Missing Item  : %d",(int)stats_read(&g->stats,STAT_MISSING)),rx+10,y,FONT_XS,BLACK); y+=14;
+         DrawText(TextFormat("Cascade Events: %d",(int)stats_read(&g->stats,STAT_CASCADE)),rx+10,y,FONT_XS,BLACK); y+=20;
  
          /* ---- ready products / ingredients / ovens ---------- */
          int colW=(DASH_W-20)/2, readyX=rx+10, ingrX=rx+10+colW;
@@ -281,14 +295,15 @@
          DrawText("Ready products:",readyX,yR,FONT_MD,DARKGRAY); yR+=20;
          DrawText("Ingredients:",   ingrX ,yI,FONT_MD,DARKGRAY);  yI+=20;
          for(int cat=0;cat<NUM_PRODUCTS;cat++){
-             const ProductCategory *pc=&g->productCatalog.categories[cat];
-             if(pc->product_count==0) continue;
+             int nProd=game_product_count(g,cat);
+             if(nProd==0) continue;
+             const ReadyProductCategory *rc=&g->ready_products.categories[g->layout.categories[cat].type];
              DrawText((const char*[]){"Bread","Cake","Sandwich","Sweet",
                                        "SweetPat.","SavoryPat."}[cat],
                       readyX,yR,FONT_SM,MAROON); yR+=16;
-             for(int p=0;p<pc->product_count;p++){
-                 int q=g->ready_products.categories[cat].quantities[p];
-                 DrawText(TextFormat("\u2022 %s: %d",pc->products[p].name,q),
+             for(int p=0;p<nProd;p++){
+                 int q=p<rc->product_count?ready[rc->first+p]:0;
+                 DrawText(TextFormat("\u2022 %s: %d",game_product(g,cat,p)->name,q),
                           readyX+12,yR,FONT_XS,BLACK); yR+=14;
                  if(yR>WIN_H-BAR_H-160){
                      DrawText("...",readyX+12,yR,FONT_XS,BLACK); goto SKIP_ING;
@@ -297,7 +312,7 @@
          }
  SKIP_ING:
          for(int ing=0;ing<NUM_INGREDIENTS;ing++){
-             float q=g->inventory.quantities[ing];
+             float q=get_ingredient(&g->inventory,ing);
              DrawText(TextFormat("%s: %.1f",get_ingredient_name(ing),q),
                       ingrX,yI,FONT_XS,BLACK); yI+=14;
              if(yI>WIN_H-BAR_H-160){
@@ -309,16 +324,19 @@
          float ovensY=yI+20;
          if(ovensY+ovenT.height>WIN_H-BAR_H-10)
              ovensY=WIN_H-BAR_H-ovenT.height-10;
-         for(int o=0;o<g->config.NUM_OVENS;o++){
+         for(int o=0;o<g->layout.oven_slots;o++){
              int x=rx+10+o*(ovenT.width+40);
              DrawTexture(ovenT,x,ovensY,WHITE);
-             Oven ov=g->ovens[o];
+             Oven ov; seqlock_read_copy_bounded(&game_oven(g,o)->seq,&ov,game_oven(g,o),sizeof(Oven));
              DrawText(ov.is_busy?"Preparing":"Idle",
                       x,ovensY+ovenT.height+4,FONT_XS,ov.is_busy?RED:DARKGREEN);
              DrawText(ov.item_name,x,ovensY+ovenT.height+18,FONT_XS,BLACK);
-             if(ov.is_busy)
-                 DrawText(TextFormat("%ds left",ov.time_left),
+             if(ov.is_busy){
+                 /* ovens carry a deadline, the countdown is derived */
+                 double left=ov.ready_at-sim_now(&g->clock);
+                 DrawText(TextFormat("%ds left",left>0?(int)ceil(left):0),
                           x,ovensY+ovenT.height+32,FONT_XS,MAROON);
+             }
          }
  
          /* ---- staff bar ------------------------------------ */
@@ -392,7 +410,8 @@
      UnloadTexture(ovenT);UnloadTexture(sheet);UnloadTexture(bg);
      UnloadSound(frustrSound); CloseAudioDevice();
  
-     munmap(custQ,queueShmSize(sizeof(Customer),g->config.MAX_CUSTOMERS));
+     customer_line_close(custQ,&g->config); free(line);
+     free(bakers); free(chefs); free(ready);
      cleanup_shared_memory(g);
      CloseWindow();
      return 0;
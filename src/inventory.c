@@ -2,176 +2,212 @@
 // Created by yazan on 4/26/2025.
 //
 
+#include <stddef.h>
 #include <string.h>
 #include <unistd.h>
 #include "inventory.h"
 #include "semaphores_utils.h"
 
+static int64_t to_fixed(float quantity) {
+    return (int64_t) (quantity * INVENTORY_SCALE + (quantity < 0 ? -0.5f : 0.5f));
+}
+
 // Initialize inventory
 void init_inventory(Inventory *inventory) {
     // Initialize all quantities to zero
     for (int i = 0; i < NUM_INGREDIENTS; i++) {
-        inventory->quantities[i] = 0;
+        __atomic_store_n(&inventory->stock[i], 0, __ATOMIC_RELAXED);
     }
+    __atomic_store_n(&inventory->paste_count, 0, __ATOMIC_RELAXED);
     inventory->max_capacity = 100; // Set a default max capacity
 }
 
-// Initialize ready products
-void init_ready_products(ReadyProducts *ready_products) {
-    // Initialize all categories and their quantities to zero
+float get_ingredient(const Inventory *inventory, IngredientType type) {
+    return (float) __atomic_load_n(&inventory->stock[type], __ATOMIC_ACQUIRE) / INVENTORY_SCALE;
+}
+
+// Initialize ready products and their shared lock
+int init_ready_products(ReadyProducts *ready_products, int *quantities, const int product_counts[NUM_PRODUCTS]) {
+    // Categories take consecutive runs of the quantities, all zero
+    int slots = 0;
     for (int i = 0; i < NUM_PRODUCTS; i++) {
-        ready_products->categories[i].product_count = 0;
-        for (int j = 0; j < MAX_PRODUCTS_PER_CATEGORY; j++) {
-            ready_products->categories[i].quantities[j] = 0;
-        }
+        ready_products->categories[i].first = slots;
+        ready_products->categories[i].product_count = product_counts[i];
+        slots += product_counts[i];
     }
+    memset(quantities, 0, (size_t) slots * sizeof(int));
+    ready_products->product_slots = slots;
+    ready_products->quantities = (char *) quantities - (char *) ready_products;
     ready_products->total_count = 0;
     ready_products->max_capacity = 50; // Set a default max capacity
+    seqlock_init(&ready_products->seq);
+    return shared_mutex_init(&ready_products->lock);
 }
 
-// Add ingredient with thread safety
-void add_ingredient(Inventory *inventory, IngredientType type, float quantity, sem_t* sem) {
-    if (!sem) {
-        sem = setup_inventory_semaphore();
-    }
-    
-    lock_inventory(sem);
-    
-    if ((type >= 0) && (type < NUM_INGREDIENTS)) {
-        inventory->quantities[type] += quantity;
-    }
-    
-    unlock_inventory(sem);
+void snapshot_ready_products(const ReadyProducts *ready_products, int *quantities) {
+    seqlock_read_copy(&ready_products->seq, quantities, ready_quantities(ready_products),
+                      (size_t) ready_products->product_slots * sizeof(int));
 }
 
-void add_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS], sem_t* sem) {
-    if (!sem) {
-        sem = setup_inventory_semaphore();
+// Add ingredient, capped at max_capacity
+float add_ingredient(Inventory *inventory, IngredientType type, float quantity) {
+    if (type < 0 || type >= NUM_INGREDIENTS) {
+        return 0;
     }
-    
-    lock_inventory(sem);
-    
+
+    int64_t *stock = &inventory->stock[type];
+    int64_t capacity = (int64_t) inventory->max_capacity * INVENTORY_SCALE;
+    int64_t current = __atomic_load_n(stock, __ATOMIC_RELAXED);
+    int64_t updated;
+
+    do {
+        updated = current + to_fixed(quantity);
+        if (updated > capacity) {
+            updated = capacity;
+        }
+    } while (!__atomic_compare_exchange_n(stock, &current, updated, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    return (float) updated / INVENTORY_SCALE;
+}
+
+void add_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS]) {
     // Add quantities from the array
     for (int i = 0; i < NUM_INGREDIENTS; i++) {
-        inventory->quantities[i] += quantities[i];
+        __atomic_add_fetch(&inventory->stock[i], to_fixed(quantities[i]), __ATOMIC_RELEASE);
     }
-    
-    unlock_inventory(sem);
 }
 
-int check_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS], sem_t* sem) {
-    if (!sem) {
-        sem = setup_inventory_semaphore();
-    }
-    
-    int result = 1;
-    
-    lock_inventory(sem);
-    
+// A racy snapshot: another process may take the ingredients right after
+int check_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS]) {
     // Check if we have enough of each ingredient
     for (int i = 0; i < NUM_INGREDIENTS; i++) {
-        if (inventory->quantities[i] < quantities[i]) {
-            result = 0; // Not enough ingredients
-            break;
+        if (__atomic_load_n(&inventory->stock[i], __ATOMIC_ACQUIRE) < to_fixed(quantities[i])) {
+            return 0; // Not enough ingredients
         }
     }
-    
-    unlock_inventory(sem);
-    
-    return result;
+    return 1;
 }
 
-void use_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS], sem_t* sem) {
-    if (!sem) {
-        sem = setup_inventory_semaphore();
-    }
-    
-    lock_inventory(sem);
-    
+void use_ingredients(Inventory *inventory, const float quantities[NUM_INGREDIENTS]) {
     // Deduct used ingredients
     for (int i = 0; i < NUM_INGREDIENTS; i++) {
-        inventory->quantities[i] -= quantities[i];
+        __atomic_sub_fetch(&inventory->stock[i], to_fixed(quantities[i]), __ATOMIC_ACQ_REL);
     }
-    
-    unlock_inventory(sem);
 }
 
-void restock_ingredients(Inventory *inventory, sem_t* sem) {
-    if (!sem) {
-        sem = setup_inventory_semaphore();
-    }
-    
-    lock_inventory(sem);
-    
+void restock_ingredients(Inventory *inventory) {
     // Reset all ingredients to 0
     for (int i = 0; i < NUM_INGREDIENTS; i++) {
-        inventory->quantities[i] = 0;
+        __atomic_store_n(&inventory->stock[i], 0, __ATOMIC_RELEASE);
     }
-    
-    unlock_inventory(sem);
 }
 
-void add_paste(Inventory *inventory, int quantity, sem_t* sem) {
-    if (!sem) {
-        sem = setup_inventory_semaphore();
+// Put back the first count ingredients of a failed reservation. This goes
+// through add_ingredient, so a supplier that filled the stock up while it was
+// taken cannot push it past max_capacity; the overflow is dropped the same
+// way a delivery's would be.
+static void release_ingredients(Inventory *inventory, const Ingredient *ingredients, int count) {
+    for (int i = 0; i < count; i++) {
+        add_ingredient(inventory, ingredients[i].type, ingredients[i].quantity);
     }
-
-    lock_inventory(sem);
-    inventory->paste_count += quantity;
-    unlock_inventory(sem);
 }
 
-int get_paste_count(Inventory *inventory, sem_t* sem) {
-    if (!sem) {
-        sem = setup_inventory_semaphore();
+// Not all-or-nothing: each ingredient is taken with its own CAS, and if one
+// runs short the ones already taken are put back. No one waits on a lock,
+// but until the rollback finishes other chefs see the earlier ingredients
+// lowered and may fail a reservation that would otherwise have succeeded.
+int reserve_ingredients(Inventory *inventory, const Ingredient *ingredients, int count) {
+    for (int i = 0; i < count; i++) {
+        int64_t *stock = &inventory->stock[ingredients[i].type];
+        int64_t needed = to_fixed(ingredients[i].quantity);
+        int64_t current = __atomic_load_n(stock, __ATOMIC_ACQUIRE);
+
+        do {
+            if (current < needed) {
+                release_ingredients(inventory, ingredients, i);
+                return 0;
+            }
+        } while (!__atomic_compare_exchange_n(stock, &current, current - needed, 1,
+                                              __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
     }
+    return 1;
+}
 
-    lock_inventory(sem);
-    int count = inventory->paste_count;
-    unlock_inventory(sem);
+void add_paste(Inventory *inventory, int quantity) {
+    __atomic_add_fetch(&inventory->paste_count, quantity, __ATOMIC_RELAXED);
+}
 
-    return count;
+int get_paste_count(Inventory *inventory) {
+    return __atomic_load_n(&inventory->paste_count, __ATOMIC_RELAXED);
 }
 
 
-// Add ready product with thread safety
-void add_ready_product(ReadyProducts *ready_products, ProductType type, int product_index, int quantity, sem_t* sem) {
-    if (!sem) {
-        sem = setup_ready_products_semaphore();
+static void lock_ready_products(ReadyProducts *ready_products) {
+    if (shared_mutex_lock(&ready_products->lock)) {
+        // The dead owner may have stopped between the two updates below,
+        // possibly with the sequence left odd
+        if (__atomic_load_n(&ready_products->seq.sequence, __ATOMIC_RELAXED) & 1) {
+            seqlock_write_end(&ready_products->seq);
+        }
+        seqlock_write_begin(&ready_products->seq);
+        int total = 0;
+        for (int i = 0; i < ready_products->product_slots; i++) {
+            total += ready_quantities(ready_products)[i];
+        }
+        ready_products->total_count = total;
+        seqlock_write_end(&ready_products->seq);
     }
+}
 
-    lock_ready_products(sem);
+static void unlock_ready_products(ReadyProducts *ready_products) {
+    shared_mutex_unlock(&ready_products->lock);
+}
 
-    if (type >= 0 && type < NUM_PRODUCTS &&
-        product_index >= 0 && product_index < MAX_PRODUCTS_PER_CATEGORY) {
-        ready_products->categories[type].quantities[product_index] += quantity;
+// Count of one product, or NULL if the catalog has no such product
+static int *ready_quantity(ReadyProducts *ready_products, ProductType type, int product_index) {
+    if (type < 0 || type >= NUM_PRODUCTS ||
+        product_index < 0 || product_index >= ready_products->categories[type].product_count) {
+        return NULL;
+    }
+    return &ready_quantities(ready_products)[ready_products->categories[type].first + product_index];
+}
+
+// Add ready product with thread safety
+void add_ready_product(ReadyProducts *ready_products, ProductType type, int product_index, int quantity) {
+
+    lock_ready_products(ready_products);
+
+    int *ready = ready_quantity(ready_products, type, product_index);
+    if (ready != NULL) {
+        seqlock_write_begin(&ready_products->seq);
+        *ready += quantity;
         ready_products->total_count += quantity;
+        seqlock_write_end(&ready_products->seq);
     }
 
-    unlock_ready_products(sem);
+    unlock_ready_products(ready_products);
 }
 
 // Get ready product with thread safety
 // Returns 1 if successful, 0 if not enough products
-int get_ready_product(ReadyProducts *ready_products, ProductType type, int product_index, int quantity, sem_t* sem) {
-    if (!sem) {
-        sem = setup_ready_products_semaphore();
-    }
+int get_ready_product(ReadyProducts *ready_products, ProductType type, int product_index, int quantity) {
 
     int result = 0;
 
-    lock_ready_products(sem);
+    lock_ready_products(ready_products);
 
-    if (type >= 0 && type < NUM_PRODUCTS &&
-        product_index >= 0 && product_index < MAX_PRODUCTS_PER_CATEGORY &&
-        ready_products->categories[type].quantities[product_index] >= quantity) {
+    int *ready = ready_quantity(ready_products, type, product_index);
+    if (ready != NULL && *ready >= quantity) {
 
-        ready_products->categories[type].quantities[product_index] -= quantity;
+        seqlock_write_begin(&ready_products->seq);
+        *ready -= quantity;
         ready_products->total_count -= quantity;
+        seqlock_write_end(&ready_products->seq);
         result = 1;
     }
 
-    unlock_ready_products(sem);
+    unlock_ready_products(ready_products);
 
     return result;
 }
@@ -180,21 +216,19 @@ int get_ready_product(ReadyProducts *ready_products, ProductType type, int produ
 
 // Check if all products in an order are available and fulfill it if they are
 // Returns 1 if order can be fulfilled, 0 otherwise
-int check_and_fulfill_order(ReadyProducts *ready_products, CustomerOrder *order, sem_t* sem) {
-    if (!sem) {
-        sem = setup_ready_products_semaphore();
-    }
+int check_and_fulfill_order(ReadyProducts *ready_products, CustomerOrder *order) {
 
     int can_fulfill = 1;
 
     // Lock the ready products for the entire operation
-    lock_ready_products(sem);
+    lock_ready_products(ready_products);
 
     // First pass: check if all items are available without removing any
     for (int i = 0; i < order->item_count; i++) {
         OrderItem *item = &order->items[i];
+        int *ready = ready_quantity(ready_products, item->type, item->product_index);
 
-        if (ready_products->categories[item->type].quantities[item->product_index] < item->quantity) {
+        if (ready == NULL || *ready < item->quantity) {
             can_fulfill = 0;
             break;
         }
@@ -203,16 +237,18 @@ int check_and_fulfill_order(ReadyProducts *ready_products, CustomerOrder *order,
 
     // Second pass: if all items are available, fulfill the order by reducing quantities
     if (can_fulfill) {
+        seqlock_write_begin(&ready_products->seq);
         for (int i = 0; i < order->item_count; i++) {
             OrderItem *item = &order->items[i];
 
-            ready_products->categories[item->type].quantities[item->product_index] -= item->quantity;
+            *ready_quantity(ready_products, item->type, item->product_index) -= item->quantity;
             ready_products->total_count -= item->quantity;
         }
+        seqlock_write_end(&ready_products->seq);
     }
 
     // Unlock the ready products
-    unlock_ready_products(sem);
+    unlock_ready_products(ready_products);
 
     return can_fulfill;
 }
@@ -220,7 +256,7 @@ int check_and_fulfill_order(ReadyProducts *ready_products, CustomerOrder *order,
 void print_inventory(Inventory *inventory) {
     printf("Inventory Contents:\n");
     for (int i = 0; i < NUM_INGREDIENTS; i++) {
-        printf("  %s: %.1f units\n", get_ingredient_name(i), inventory->quantities[i]);
+        printf("  %s: %.1f units\n", get_ingredient_name(i), get_ingredient(inventory, i));
     }
     printf("-------------------------------\n");
 }
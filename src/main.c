@@ -1,12 +1,14 @@
+#include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/wait.h>
 #include <unistd.h>
 #include "assets.h"
+#include "bakery_message.h"
 #include "config.h"
 #include "game.h"
-#include "queue.h"
+#include "random.h"
 #include "shared_mem_utils.h"
 #include "semaphores_utils.h"
 
@@ -15,34 +17,7 @@ Game  *shared_game         = NULL;
 pid_t  processes[6];
 pid_t *processes_sellers   = NULL;
 int    shm_fd              = -1;
-queue_shm *queue           = NULL;
-
-/* ---- NEW: tick all ovens once per real‑time second -------- */
-static void tick_all_ovens(Game *g)
-{
-    for (int i = 0; i < g->config.NUM_OVENS; ++i) {
-        Oven *ov = &g->ovens[i];
-        if (!ov->is_busy) continue;
-
-        if (--ov->time_left <= 0) {
-            ov->is_busy = 0;
-            printf("[main] Oven %d finished baking %s (team %s)\n",
-                   ov->id, ov->item_name, ov->team_name);
-
-            /* clear the text fields (same as old oven_tick) */
-            ov->item_name[0] = '\0';
-            ov->team_name[0] = '\0';
-        }
-    }
-}
-
-/* ----------------------------------------------------------- */
-void handle_alarm(int signum)
-{
-    shared_game->elapsed_time++;   /* original work            */
-    tick_all_ovens(shared_game);   /* NEW: simulate ovens      */
-    alarm(1);                      /* re‑arm                   */
-}
+ShmArena *arena            = NULL;
 
 void cleanup_resources(void);
 void handle_kill(int);
@@ -52,31 +27,56 @@ int main(int argc,char *argv[])
     printf("********** Bakery Simulation **********\n\n");
     fflush(stdout);
 
+    /* name every shared resource after this run before touching any */
+    ipc_init_instance();
     reset_all_semaphores();
 
     atexit(cleanup_resources);
 
-    shm_fd = setup_shared_memory(&shared_game);
-    setup_queue_shared_memory(&queue,shared_game->config.MAX_CUSTOMERS);
-
-    processes_sellers = malloc(shared_game->config.NUM_SELLERS*sizeof(pid_t));
-
-    signal(SIGALRM,handle_alarm);
     signal(SIGINT ,handle_kill);
 
-    if (load_config(CONFIG_PATH,&shared_game->config)==-1){
+    /* the config and catalog size the game segment, so they are read first */
+    Config config;
+    if (load_config(CONFIG_PATH,&config)==-1){
         printf("Config file failed\n"); return 1;
     }
-    if (load_product_catalog(CONFIG_PATH_JSON,&shared_game->productCatalog)==-1){
+    ProductCatalog catalog;
+    if (load_product_catalog(CONFIG_PATH_JSON,&catalog)==-1){
         printf("Product catalog file failed\n"); return 1;
     }
+    shm_fd = create_shared_memory(&config,&catalog,&shared_game);
+    free_product_catalog(&catalog);
+
+    /* orders and supply orders are allocated here and passed by ref */
+    arena = shm_arena_create(BAKERY_ARENA_SHM_NAME, bakery_arena_size(&config));
+    if (arena == NULL) {
+        printf("Bakery arena failed\n"); return 1;
+    }
+
+    processes_sellers = calloc(shared_game->config.NUM_SELLERS,sizeof(pid_t));
+
+    /* every process derives its random streams from this one seed */
+    shared_game->config.SEED = resolve_seed(shared_game->config.SEED);
+    printf("Seed: %u\n", shared_game->config.SEED);
+
+    /* start the simulated clock before any worker reads it */
+    sim_clock_init(&shared_game->clock, shared_game->config.TIME_SCALE);
+
+    /* chefs and bakers map the bake channels, lay them out first */
+    if (open_bake_channels(1) == NULL) {
+        printf("Bake channels failed\n"); return 1;
+    }
 
     game_init(shared_game,processes,processes_sellers,shm_fd);
 
-    alarm(1);               /* start 1‑second timer */
+    /* elapsed time and oven completions are driven from one thread */
+    pthread_t clock_tid;
+    if (pthread_create(&clock_tid, NULL, run_game_clock, shared_game) != 0) {
+        perror("Failed to start clock thread"); return 1;
+    }
 
-    /* empty polling loop – stays as before */
-    while (check_game_conditions(shared_game)){ /* nothing */ }
+    /* sleep until a counter update ends the game */
+    wait_for_game_over(shared_game);
 
     /* wait for graphics process (index 0 in your array) */
     int status_graphics;
@@ -95,9 +95,19 @@ void cleanup_resources()
 {
     printf("Cleaning up resources...\n"); fflush(stdout);
 
-    for(int i=0;i<6;i++) kill(processes[i],SIGINT);
+    /* only started children: kill(0,...) would signal main's whole group,
+       main included, and cut this cleanup short */
+    for(int i=0;i<6;i++) if(processes[i]>0) kill(processes[i],SIGINT);
+    for(int i=0;processes_sellers&&shared_game&&i<shared_game->config.NUM_SELLERS;i++)
+        if(processes_sellers[i]>0) kill(processes_sellers[i],SIGINT);
+    /* named after this run, so nothing else would ever unlink them */
+    if (shared_game) cleanup_oven_semaphores(shared_game->layout.oven_slots);
+    sem_unlink(COMPLAINT_SEM_NAME);
     cleanup_shared_memory(shared_game);
     shm_unlink(CUSTOMER_QUEUE_SHM_NAME);
+    shm_unlink(BAKE_CHANNEL_SHM_NAME);
+    shm_arena_unmap(arena);
+    shm_unlink(BAKERY_ARENA_SHM_NAME);
     free(processes_sellers);
     printf("Cleanup complete\n");
 }
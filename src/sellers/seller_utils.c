@@ -2,10 +2,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/msg.h>
+#include <unistd.h>
 
 #include "seller.h"
 #include "bakery_message.h"
 #include "customer.h"
+#include "seller_worker.h"
 
 // Get a descriptive string for seller state
 const char* get_seller_state_string(SellerState state) {
@@ -25,4 +27,191 @@ void init_seller(Seller *seller, int id) {
     seller->id = id;
     seller->pid = getpid();
     seller->state = IDLE;
-}
\ No newline at end of file
+    seller->serving = 0;
+}
+
+static void send_seller_message(SellerContext *ctx, pid_t customer_key, SellerNotice notice,
+                                OrderResult result, float total_price) {
+    SellerMessage msg;
+    msg.mtype = customer_key;
+    msg.notice = notice;
+    msg.result = result;
+    msg.total_price = total_price;
+
+    if (msgsnd(ctx->customer_inbox_id, &msg, sizeof(SellerMessage) - sizeof(long), 0) == -1) {
+        perror("Failed to send seller message");
+    }
+}
+
+/* --- pipelined serving ---------------------------------------------- */
+
+#define CALL_TIME 2.0           // Before the seller calls a customer
+#define PROCESSING_TIME 2.0     // Preparing an order once it arrives
+#define ORDER_POLL 0.25         // Between checks for orders that have not arrived
+
+typedef enum {
+    SLOT_FREE,
+    SLOT_CALLING,               // Customer taken off the line, not called yet
+    SLOT_AWAITING_ORDER,        // Called, the order has not arrived
+    SLOT_PROCESSING,            // Order in hand, being prepared
+    SLOT_AWAITING_PRODUCTS      // Prepared, some products are not ready yet
+} SlotPhase;
+
+// One customer in the seller's window
+typedef struct {
+    SlotPhase phase;
+    Customer customer;
+    double due;                 // When the phase ends or is checked next
+    double give_up;             // AWAITING_PRODUCTS: when the order goes missing
+    ShmRef order;
+} SellerSlot;
+
+static void finish_slot(SellerContext *ctx, SellerSlot *slot) {
+    shm_arena_free(ctx->arena, slot->order);
+    slot->order = SHM_REF_NULL;
+    slot->phase = SLOT_FREE;
+    __atomic_sub_fetch(&ctx->seller->serving, 1, __ATOMIC_RELAXED);
+}
+
+// Takes the products off the shelves; 0 while some are missing
+static int fulfil_order(SellerContext *ctx, SellerSlot *slot) {
+    CustomerOrder *order = shm_arena_ptr(ctx->arena, slot->order);
+    if (!check_and_fulfill_order(&ctx->game->ready_products, order)) {
+        return 0;
+    }
+
+    send_seller_message(ctx, slot->customer.pid, ORDER_COMPLETED, ORDER_SUCCESS, order->total_price);
+    stats_add_profit(&ctx->game->stats, order->total_price);
+    notify_game_state(ctx->game);
+    return 1;
+}
+
+// Moves the slot on if its phase is over
+static void step_slot(SellerContext *ctx, SellerSlot *slot, double now) {
+    Seller *seller = ctx->seller;
+
+    if (slot->phase == SLOT_FREE || now < slot->due) {
+        return;
+    }
+
+    switch (slot->phase) {
+        case SLOT_CALLING:
+            seller->state = TAKING_ORDER;
+            send_seller_message(ctx, slot->customer.pid, SELLER_CALLING, ORDER_SUCCESS, 0.0f);
+            printf("Seller %d: Called customer %d\n", seller->id, slot->customer.id);
+            slot->phase = SLOT_AWAITING_ORDER;
+            slot->due = now;
+            break;
+
+        case SLOT_AWAITING_ORDER: {
+            ShmRef ref;
+            int taken = customer_line_take_order(ctx->customer_line, slot->customer.pid, &ref);
+            if (taken == 0) {
+                slot->due = now + ORDER_POLL;
+                break;
+            }
+            if (taken == -1) {
+                // The customer left before ordering
+                finish_slot(ctx, slot);
+                break;
+            }
+
+            CustomerOrder *order = shm_arena_ptr(ctx->arena, ref);
+            printf("Seller %d: Processing order from customer %d with %d items, total price: %.2f\n",
+                   seller->id, slot->customer.id, order->item_count, order->total_price);
+            seller->state = PROCESSING_ORDER;
+            slot->order = ref;
+            slot->phase = SLOT_PROCESSING;
+            slot->due = now + PROCESSING_TIME;
+            break;
+        }
+
+        case SLOT_PROCESSING:
+        case SLOT_AWAITING_PRODUCTS:
+            seller->state = COMPLETING_ORDER;
+            if (!customer_line_present(ctx->customer_line, slot->customer.pid)) {
+                // The customer gave up while the order was prepared: keep
+                // the products on the shelves and message no one
+                printf("Seller %d: Customer %d left, dropping their order\n",
+                       seller->id, slot->customer.id);
+                finish_slot(ctx, slot);
+            } else if (fulfil_order(ctx, slot)) {
+                finish_slot(ctx, slot);
+            } else {
+                if (slot->phase == SLOT_PROCESSING) {
+                    // Hold the order for PRODUCT_WAIT: the bakers may have
+                    // some on the way. With the default of 0 it goes missing now
+                    slot->phase = SLOT_AWAITING_PRODUCTS;
+                    slot->give_up = now + ctx->game->config.PRODUCT_WAIT;
+                }
+                if (now >= slot->give_up) {
+                    printf("Seller %d: Order of customer %d could not be fulfilled\n",
+                           seller->id, slot->customer.id);
+                    send_seller_message(ctx, slot->customer.pid, ORDER_COMPLETED, ORDER_MISSING, 0.0f);
+                    finish_slot(ctx, slot);
+                } else {
+                    slot->due = now + ORDER_POLL;
+                }
+            }
+            break;
+
+        case SLOT_FREE:
+            break;
+    }
+}
+
+// Serves up to SELLER_WINDOW customers at once. Rather than sleeping
+// through each customer's call and preparation in turn, the seller keeps a
+// deadline per customer, sleeps until the earliest one and takes more
+// customers off the line in the meantime.
+void seller_loop(SellerContext *ctx) {
+    Seller *seller = ctx->seller;
+    Game *game = ctx->game;
+    int window = game->config.SELLER_WINDOW;
+
+    SellerSlot *slots = calloc((size_t) window, sizeof(SellerSlot));
+    if (slots == NULL) {
+        perror("Failed to allocate seller window");
+        return;
+    }
+
+    while (*ctx->running && !__atomic_load_n(&game->game_over, __ATOMIC_ACQUIRE)) {
+        double now = sim_now(&game->clock);
+        double next_due = now + 1;   // Wake once a simulated second to notice the game ending
+        SellerSlot *free_slot = NULL;
+
+        for (int i = 0; i < window; i++) {
+            step_slot(ctx, &slots[i], now);
+            if (slots[i].phase == SLOT_FREE) {
+                free_slot = free_slot != NULL ? free_slot : &slots[i];
+            } else if (slots[i].due < next_due) {
+                next_due = slots[i].due;
+            }
+        }
+        if (seller->serving == 0) {
+            seller->state = IDLE;
+        }
+
+        double wait = next_due - now;
+        if (free_slot == NULL) {
+            sim_sleep(&game->clock, wait);
+            continue;
+        }
+
+        // Takes from its own lane, then the others; sleeps on its lane
+        // until a customer arrives or the next deadline
+        struct timespec timeout = sim_real_timespec(&game->clock, wait > 0 ? wait : 0);
+        if (customer_line_next(ctx->customer_line, seller->id, &free_slot->customer, &timeout) == 0) {
+            printf("Seller %d: Dequeued customer %d\n", seller->id, free_slot->customer.id);
+            free_slot->phase = SLOT_CALLING;
+            free_slot->due = sim_now(&game->clock) + CALL_TIME;
+            __atomic_add_fetch(&seller->serving, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Orders still in hand go back to the arena
+    for (int i = 0; i < window; i++) {
+        shm_arena_free(ctx->arena, slots[i].order);
+    }
+    free(slots);
+}
@@ -0,0 +1,336 @@
+//
+// Monte Carlo batch runner: many headless simulated days across all cores.
+//
+// Every run is a forked child running run_headless_simulation on its own
+// private Game, so runs share no named IPC resources. Each KEY=v1,v2,...
+// argument overrides a config value; the runner takes the cartesian product
+// of all overrides and does `runs` replications of each point. Replication
+// i uses seed + i at every point, so points are compared on the same random
+// streams. Results go to a CSV with one row per point and counter.
+//
+// Usage: bakery_batch [-n runs] [-j jobs] [-s seed] [-o out.csv]
+//                     [-c config.txt] [-p config.json] [KEY=v1,v2,...]...
+//
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "batch_stats.h"
+#include "config.h"
+#include "game.h"
+#include "random.h"
+#include "simulation.h"
+
+#define MAX_OVERRIDES 8
+#define MAX_OVERRIDE_VALUES 32
+
+typedef enum {
+    METRIC_SERVED,
+    METRIC_FRUSTRATED,
+    METRIC_COMPLAINED,
+    METRIC_MISSING,
+    METRIC_CASCADE,
+    METRIC_PROFIT,
+    NUM_METRICS
+} Metric;
+
+static const char *metric_names[NUM_METRICS] = {
+    "served", "frustrated", "complained", "missing", "cascade", "daily_profit"
+};
+
+typedef struct {
+    char key[50];
+    double values[MAX_OVERRIDE_VALUES];
+    int count;
+} Override;
+
+// Filled in by the child in the shared results array
+typedef struct {
+    int ok;
+    double metrics[NUM_METRICS];
+} RunResult;
+
+static Override overrides[MAX_OVERRIDES];
+static int num_overrides = 0;
+
+static int parse_override(const char *arg) {
+    const char *equals = strchr(arg, '=');
+    if (equals == NULL || equals == arg || equals - arg >= (long) sizeof(overrides[0].key)) {
+        fprintf(stderr, "Bad override: %s (expected KEY=v1,v2,...)\n", arg);
+        return -1;
+    }
+    if (num_overrides == MAX_OVERRIDES) {
+        fprintf(stderr, "At most %d overrides\n", MAX_OVERRIDES);
+        return -1;
+    }
+
+    Override *override = &overrides[num_overrides];
+    memcpy(override->key, arg, equals - arg);
+    override->key[equals - arg] = '\0';
+    override->count = 0;
+
+    // Reject unknown keys up front instead of in every child
+    Config probe;
+    if (set_config_value(&probe, override->key, 0) == -1) {
+        fprintf(stderr, "Unknown config key: %s\n", override->key);
+        return -1;
+    }
+
+    const char *cursor = equals + 1;
+    while (*cursor != '\0') {
+        char *end;
+        double value = strtod(cursor, &end);
+        if (end == cursor || override->count == MAX_OVERRIDE_VALUES) {
+            fprintf(stderr, "Bad values for %s\n", override->key);
+            return -1;
+        }
+        override->values[override->count++] = value;
+        cursor = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') {
+            fprintf(stderr, "Bad values for %s\n", override->key);
+            return -1;
+        }
+    }
+    if (override->count == 0) {
+        fprintf(stderr, "No values for %s\n", override->key);
+        return -1;
+    }
+
+    num_overrides++;
+    return 0;
+}
+
+// Value index of every override at one point of the cartesian product
+static void point_indices(int point, int *indices) {
+    for (int i = num_overrides - 1; i >= 0; i--) {
+        indices[i] = point % overrides[i].count;
+        point /= overrides[i].count;
+    }
+}
+
+static int apply_point(Config *config, int point) {
+    int indices[MAX_OVERRIDES];
+    point_indices(point, indices);
+    for (int i = 0; i < num_overrides; i++) {
+        set_config_value(config, overrides[i].key, overrides[i].values[indices[i]]);
+    }
+    return check_parameter_correctness(config);
+}
+
+// Child side of one run; never returns
+static void run_child(const Game *base, const ProductCatalog *catalog, int point, unsigned int seed,
+                      RunResult *result) {
+    // Keep the parent's terminal readable; errors still go to stderr
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd != -1) {
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+
+    // Overrides can change the staff counts, so each run sizes its own Game
+    Config config = base->config;
+    if (apply_point(&config, point) == -1) {
+        _exit(1);
+    }
+    Game *game = game_alloc(&config, catalog);
+    if (game == NULL) {
+        _exit(1);
+    }
+
+    if (run_headless_simulation(game, seed, NULL) == -1) {
+        _exit(1);
+    }
+
+    result->metrics[METRIC_SERVED] = stats_read(&game->stats, STAT_SERVED);
+    result->metrics[METRIC_FRUSTRATED] = stats_read(&game->stats, STAT_FRUSTRATED);
+    result->metrics[METRIC_COMPLAINED] = stats_read(&game->stats, STAT_COMPLAINED);
+    result->metrics[METRIC_MISSING] = stats_read(&game->stats, STAT_MISSING);
+    result->metrics[METRIC_CASCADE] = stats_read(&game->stats, STAT_CASCADE);
+    result->metrics[METRIC_PROFIT] = stats_profit(&game->stats);
+    result->ok = 1;
+    _exit(0);
+}
+
+static int write_csv(FILE *out, RunResult *results, int num_points, int runs) {
+    double *values = malloc(runs * sizeof(double));
+    if (values == NULL) {
+        perror("Failed to allocate values");
+        return -1;
+    }
+
+    for (int i = 0; i < num_overrides; i++) {
+        fprintf(out, "%s,", overrides[i].key);
+    }
+    fprintf(out, "metric,runs,mean,stddev,ci95_low,ci95_high,min,p5,p50,p95,max\n");
+
+    for (int point = 0; point < num_points; point++) {
+        int indices[MAX_OVERRIDES];
+        point_indices(point, indices);
+
+        for (int metric = 0; metric < NUM_METRICS; metric++) {
+            int n = 0;
+            for (int run = 0; run < runs; run++) {
+                RunResult *result = &results[point * runs + run];
+                if (result->ok) {
+                    values[n++] = result->metrics[metric];
+                }
+            }
+            if (n == 0) {
+                continue;
+            }
+
+            BatchSummary summary;
+            summarize_values(values, n, &summary);
+
+            for (int i = 0; i < num_overrides; i++) {
+                fprintf(out, "%g,", overrides[i].values[indices[i]]);
+            }
+            fprintf(out, "%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                    metric_names[metric], summary.n, summary.mean, summary.stddev,
+                    summary.ci_low, summary.ci_high, summary.min,
+                    summary.p5, summary.p50, summary.p95, summary.max);
+        }
+    }
+
+    free(values);
+    return 0;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "Usage: %s [-n runs] [-j jobs] [-s seed] [-o out.csv] "
+                    "[-c config.txt] [-p config.json] [KEY=v1,v2,...]...\n", program);
+}
+
+int main(int argc, char *argv[]) {
+    int runs = 30;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int seed = 0;   // -s, else the config's SEED, else a fresh one
+    const char *output_path = "-";
+    const char *config_path = CONFIG_PATH;
+    const char *catalog_path = CONFIG_PATH_JSON;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:j:s:o:c:p:")) != -1) {
+        switch (opt) {
+            case 'n': runs = atoi(optarg); break;
+            case 'j': jobs = atol(optarg); break;
+            case 's': seed = (unsigned int) strtoul(optarg, NULL, 10); break;
+            case 'o': output_path = optarg; break;
+            case 'c': config_path = optarg; break;
+            case 'p': catalog_path = optarg; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        if (parse_override(argv[i]) == -1) {
+            return 1;
+        }
+    }
+    if (runs < 1 || jobs < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Config config;
+    if (load_config(config_path, &config) == -1) {
+        printf("Config file failed\n");
+        return 1;
+    }
+    // Kept for the children, each lays out its own Game from it
+    ProductCatalog catalog;
+    if (load_product_catalog(catalog_path, &catalog) == -1) {
+        printf("Product catalog file failed\n");
+        return 1;
+    }
+    Game *base = game_alloc(&config, &catalog);
+    if (base == NULL) {
+        free_product_catalog(&catalog);
+        return 1;
+    }
+
+    seed = resolve_seed(seed != 0 ? seed : base->config.SEED);
+    fprintf(stderr, "Base seed: %u\n", seed);
+
+    int num_points = 1;
+    for (int i = 0; i < num_overrides; i++) {
+        num_points *= overrides[i].count;
+    }
+    int total = num_points * runs;
+
+    // Children write their counters straight into this array
+    size_t results_size = total * sizeof(RunResult);
+    RunResult *results = mmap(NULL, results_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (results == MAP_FAILED) {
+        perror("mmap");
+        free(base);
+        free_product_catalog(&catalog);
+        return 1;
+    }
+    memset(results, 0, results_size);
+
+    fflush(stdout);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int next_run = 0, running = 0, failed = 0;
+    while (next_run < total || running > 0) {
+        if (next_run < total && running < jobs) {
+            int point = next_run / runs;
+            unsigned int run_seed = seed + (unsigned int) (next_run % runs);
+
+            pid_t pid = fork();
+            if (pid == 0) {
+                run_child(base, &catalog, point, run_seed, &results[next_run]);
+            }
+            if (pid == -1) {
+                perror("fork");
+                if (running == 0) {
+                    break;
+                }
+            } else {
+                next_run++;
+                running++;
+                continue;
+            }
+        }
+
+        int status;
+        if (wait(&status) > 0) {
+            running--;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                failed++;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "%d runs (%d points x %d) on %ld jobs in %.2f s, %d failed\n",
+            next_run, num_points, runs, jobs, elapsed, failed);
+
+    FILE *out = strcmp(output_path, "-") == 0 ? stdout : fopen(output_path, "w");
+    if (out == NULL) {
+        perror("Failed to open output file");
+        munmap(results, results_size);
+        free(base);
+        free_product_catalog(&catalog);
+        return 1;
+    }
+
+    int written = write_csv(out, results, num_points, runs);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    munmap(results, results_size);
+    free(base);
+    free_product_catalog(&catalog);
+    return written == -1 || failed == total ? 1 : 0;
+}
@@ -0,0 +1,55 @@
+//
+// Headless runner: one full simulated day without sleeping.
+//
+// Usage: bakery_sim [seed] [config.txt] [config.json]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "config.h"
+#include "game.h"
+#include "simulation.h"
+
+int main(int argc, char *argv[]) {
+    unsigned int seed = argc > 1 ? (unsigned int) strtoul(argv[1], NULL, 10) : (unsigned int) time(NULL);
+    const char *config_path = argc > 2 ? argv[2] : CONFIG_PATH;
+    const char *catalog_path = argc > 3 ? argv[3] : CONFIG_PATH_JSON;
+
+    Config config;
+    if (load_config(config_path, &config) == -1) {
+        printf("Config file failed\n");
+        return 1;
+    }
+    ProductCatalog catalog;
+    if (load_product_catalog(catalog_path, &catalog) == -1) {
+        printf("Product catalog file failed\n");
+        return 1;
+    }
+    Game *game = game_alloc(&config, &catalog);
+    free_product_catalog(&catalog);
+    if (!game) {
+        return 1;
+    }
+
+    SimStats stats;
+    clock_t start = clock();
+    if (run_headless_simulation(game, seed, &stats) == -1) {
+        free(game);
+        return 1;
+    }
+    double wall_ms = (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+    printf("********** Headless Simulation **********\n");
+    printf("Seed: %u\n", seed);
+    printf("Simulated time: %d s (%ld events, %.2f ms)\n", game->elapsed_time, stats.events_processed, wall_ms);
+    printf("Customers served: %d\n", (int) stats_read(&game->stats, STAT_SERVED));
+    printf("Frustrated customers: %d\n", (int) stats_read(&game->stats, STAT_FRUSTRATED));
+    printf("Complained customers: %d\n", (int) stats_read(&game->stats, STAT_COMPLAINED));
+    printf("Missing orders: %d\n", (int) stats_read(&game->stats, STAT_MISSING));
+    printf("Cascade departures: %d\n", (int) stats_read(&game->stats, STAT_CASCADE));
+    printf("Daily profit: %.2f\n", stats_profit(&game->stats));
+
+    free(game);
+    return 0;
+}
@@ -0,0 +1,850 @@
+//
+// Headless discrete-event simulation of the bakery.
+//
+// Every actor of the process version is modelled as a small state machine.
+// Instead of sleep()/alarm() the actors schedule their next step on an event
+// calendar, and the clock jumps straight to the next event.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simulation.h"
+#include "event_queue.h"
+#include "bakery_message.h"
+#include "bakery_utils.h"
+#include "chef.h"
+#include "customer.h"
+#include "inventory.h"
+#include "random.h"
+#include "semaphores_utils.h"
+#include "team.h"
+
+#define TICK_INTERVAL 1.0          // customer manager loop / main alarm
+#define SUPPLY_CHECK_INTERVAL 2.0  // supply chain manager loop
+#define CHEF_RETRY_DELAY 3.0       // chef waiting for ingredients
+#define CUSTOMER_ORDERING_TIME 2.0 // customer choosing an order
+#define SELLER_CALL_TIME 2.0       // seller before calling a customer
+#define SELLER_PROCESSING_TIME 2.0 // seller preparing an order
+#define SELLER_PAUSE 1.0           // seller loop delay between customers
+#define SUPPLY_CHAIN_PAUSE 1.0     // supply chain loop delay between deliveries
+
+typedef enum {
+    EV_TICK,
+    EV_SUPPLY_CHECK,
+    EV_SUPPLY_POLL,
+    EV_SUPPLY_DELIVERED,
+    EV_REBALANCE,
+    EV_CHEF_START,
+    EV_CHEF_DONE,
+    EV_BAKER_START,
+    EV_BAKER_PREPARED,
+    EV_OVEN_DONE,
+    EV_CUSTOMER_ARRIVED,
+    EV_SELLER_FREE,
+    EV_SELLER_CALL,
+    EV_ORDER_PLACED,
+    EV_ORDER_FILLED
+} SimEventType;
+
+// Growable FIFO of fixed-size elements
+typedef struct {
+    char *data;
+    size_t elem_size;
+    size_t head;
+    size_t count;
+    size_t capacity;
+} SimFifo;
+
+typedef struct {
+    ChefTeam team;          // Team the current product belongs to
+    int product_index;
+} SimChef;
+
+typedef struct {
+    ChefMessage job;        // Item being baked
+    int oven;               // Oven in use or -1
+    int scheduled;          // A start event is already pending
+} SimBaker;
+
+typedef struct {
+    int count;
+    Ingredient items[NUM_INGREDIENTS];
+} SimSupplyOrder;
+
+typedef struct {
+    SimFifo orders;
+    SimSupplyOrder current;
+    int busy;
+} SimSupplyChain;
+
+typedef struct {
+    Customer entry;
+    float original_patience;
+    int generation;         // Bumped when the slot is reused, invalidates old events
+    int in_use;
+    int called;             // Seller called the customer, patience stops decaying
+    int seller;
+    CustomerOrder order;
+} SimCustomer;
+
+typedef struct {
+    int slot;
+    int generation;
+} LineEntry;
+
+typedef struct {
+    int busy;
+    int customer;
+    int generation;
+} SimSeller;
+
+typedef struct {
+    Game *game;
+    EventQueue events;
+    double now;
+    RandomStream rng;
+
+
+    int num_chefs;
+    int num_bakers;
+    int num_ovens;
+    int num_sellers;
+    int num_supply_chains;
+
+    SimChef *chefs;
+    SimBaker *bakers;
+    int *oven_owner;
+    SimFifo oven_waiters;
+    SimFifo baker_jobs[NUM_BAKERY_TEAMS];
+    SimSupplyChain *supply_chains;
+    SimSeller *sellers;
+
+    SimCustomer *customers;
+    int max_customers;
+    int active_customers;
+    int next_customer_id;
+    SimFifo line;
+} Simulation;
+
+
+static int fifo_init(SimFifo *fifo, size_t elem_size, size_t capacity) {
+    fifo->data = malloc(elem_size * capacity);
+    if (!fifo->data) {
+        return -1;
+    }
+    fifo->elem_size = elem_size;
+    fifo->head = 0;
+    fifo->count = 0;
+    fifo->capacity = capacity;
+    return 0;
+}
+
+static void fifo_destroy(SimFifo *fifo) {
+    free(fifo->data);
+    fifo->data = NULL;
+}
+
+static int fifo_push(SimFifo *fifo, const void *elem) {
+    if (fifo->count == fifo->capacity) {
+        size_t new_capacity = fifo->capacity * 2;
+        char *data = malloc(fifo->elem_size * new_capacity);
+        if (!data) {
+            return -1;
+        }
+        // Unwrap the ring into the new buffer
+        for (size_t i = 0; i < fifo->count; i++) {
+            size_t index = (fifo->head + i) % fifo->capacity;
+            memcpy(data + i * fifo->elem_size, fifo->data + index * fifo->elem_size, fifo->elem_size);
+        }
+        free(fifo->data);
+        fifo->data = data;
+        fifo->head = 0;
+        fifo->capacity = new_capacity;
+    }
+
+    size_t tail = (fifo->head + fifo->count) % fifo->capacity;
+    memcpy(fifo->data + tail * fifo->elem_size, elem, fifo->elem_size);
+    fifo->count++;
+    return 0;
+}
+
+static int fifo_pop(SimFifo *fifo, void *elem) {
+    if (fifo->count == 0) {
+        return -1;
+    }
+    memcpy(elem, fifo->data + fifo->head * fifo->elem_size, fifo->elem_size);
+    fifo->head = (fifo->head + 1) % fifo->capacity;
+    fifo->count--;
+    return 0;
+}
+
+static void schedule(Simulation *sim, double delay, SimEventType type, int actor, int data) {
+    if (event_queue_push(&sim->events, sim->now + delay, type, actor, data) == -1) {
+        fprintf(stderr, "Simulation: failed to schedule event %d\n", type);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static int random_between(Simulation *sim, int min, int max) {
+    return random_int(&sim->rng, min, max);
+}
+
+
+/* ---------- customers ------------------------------------------ */
+
+// Same accounting as customer_manager's handle_customer_state
+static void record_departure(Simulation *sim, SimCustomer *customer, CustomerState final_state, ActionType action) {
+    Game *game = sim->game;
+
+    if (action == LEAVING_NORMALLY) {
+        stats_add(&game->stats, STAT_SERVED, 1);
+    } else {
+        switch (final_state) {
+            case FRUSTRATED:
+                stats_add(&game->stats, STAT_FRUSTRATED, 1);
+                break;
+            case COMPLAINING:
+                stats_add(&game->stats, STAT_COMPLAINED, 1);
+                game->complaining_customer_pid = customer->entry.pid;
+                game->last_complaint_time = game->elapsed_time;
+                game->recent_complaint = true;
+                break;
+            case MISSING_ORDER:
+                stats_add(&game->stats, STAT_MISSING, 1);
+                break;
+            case CONTAGION:
+                stats_add(&game->stats, STAT_CASCADE, 1);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void leave_bakery(Simulation *sim, int slot, CustomerState final_state, ActionType action) {
+    SimCustomer *customer = &sim->customers[slot];
+
+    customer->entry.state = final_state;
+    record_departure(sim, customer, final_state, action);
+
+    // Entries still in the line are skipped lazily by the sellers
+    customer->in_use = 0;
+    customer->generation++;
+    sim->active_customers--;
+}
+
+static void wake_idle_seller(Simulation *sim) {
+    for (int i = 0; i < sim->num_sellers; i++) {
+        if (!sim->sellers[i].busy) {
+            sim->sellers[i].busy = 1;
+            schedule(sim, 0, EV_SELLER_FREE, i, 0);
+            return;
+        }
+    }
+}
+
+static void spawn_customer(Simulation *sim) {
+    int slot = -1;
+    for (int i = 0; i < sim->max_customers; i++) {
+        if (!sim->customers[i].in_use) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot == -1) {
+        return;
+    }
+
+    SimCustomer *customer = &sim->customers[slot];
+    create_random_customer(&customer->entry, &sim->game->config, &sim->rng);
+    customer->entry.id = sim->next_customer_id++;
+    customer->entry.pid = customer->entry.id + 1;  // No process, the id stands in for the pid
+    customer->original_patience = customer->entry.patience;
+    customer->in_use = 1;
+    customer->called = 0;
+    customer->seller = -1;
+    sim->active_customers++;
+
+    // Customers enter the line as soon as they are spawned, like in customer_manager
+    LineEntry entry = {slot, customer->generation};
+    if (fifo_push(&sim->line, &entry) == -1) {
+        fprintf(stderr, "Simulation: failed to add customer to line\n");
+        exit(EXIT_FAILURE);
+    }
+    wake_idle_seller(sim);
+
+    schedule(sim, random_between(sim, 1, 3), EV_CUSTOMER_ARRIVED, slot, customer->generation);
+}
+
+static void check_for_contagion(Simulation *sim, int slot) {
+    Game *game = sim->game;
+    SimCustomer *customer = &sim->customers[slot];
+
+    if (!game->recent_complaint || game->complaining_customer_pid == customer->entry.pid) {
+        return;
+    }
+    if (random_float(&sim->rng, 0, 1) < game->config.CUSTOMER_CASCADE_PROBABILITY) {
+        leave_bakery(sim, slot, CONTAGION, LEAVING_EARLY);
+    }
+}
+
+// Patience decay and contagion, once per simulated second
+static void update_customers(Simulation *sim) {
+    for (int i = 0; i < sim->max_customers; i++) {
+        SimCustomer *customer = &sim->customers[i];
+        if (!customer->in_use || customer->called) {
+            continue;
+        }
+
+        check_for_contagion(sim, i);
+        if (!customer->in_use) {
+            continue;
+        }
+
+        customer->entry.patience -= customer->entry.patience_decay;
+        if (customer->entry.patience <= 0) {
+            leave_bakery(sim, i, FRUSTRATED, LEAVING_EARLY);
+        }
+    }
+}
+
+static void handle_tick(Simulation *sim) {
+    Game *game = sim->game;
+
+    game->elapsed_time++;
+
+    update_customers(sim);
+
+    // Reset complaint after CASCADE_WINDOW seconds
+    if (game->recent_complaint &&
+        game->elapsed_time - game->last_complaint_time > game->config.CASCADE_WINDOW) {
+        game->recent_complaint = false;
+    }
+
+    if (sim->active_customers < sim->max_customers &&
+        random_float(&sim->rng, 0, 1) < game->config.CUSTOMER_PROBABILITY) {
+        spawn_customer(sim);
+    }
+
+    schedule(sim, TICK_INTERVAL, EV_TICK, 0, 0);
+}
+
+
+/* ---------- sellers -------------------------------------------- */
+
+static void handle_seller_free(Simulation *sim, int seller_id) {
+    SimSeller *seller = &sim->sellers[seller_id];
+    Seller *info = game_seller(sim->game, seller_id);
+    LineEntry entry;
+
+    // Skip customers that left the line early
+    while (fifo_pop(&sim->line, &entry) == 0) {
+        SimCustomer *customer = &sim->customers[entry.slot];
+        if (!customer->in_use || customer->generation != entry.generation) {
+            continue;
+        }
+
+        seller->busy = 1;
+        seller->customer = entry.slot;
+        seller->generation = entry.generation;
+        customer->seller = seller_id;
+        info->state = TAKING_ORDER;
+        schedule(sim, SELLER_CALL_TIME, EV_SELLER_CALL, seller_id, entry.generation);
+        return;
+    }
+
+    // Nobody waiting, sleep until a customer is spawned
+    seller->busy = 0;
+    info->state = IDLE;
+}
+
+static void handle_seller_call(Simulation *sim, int seller_id) {
+    SimSeller *seller = &sim->sellers[seller_id];
+    SimCustomer *customer = &sim->customers[seller->customer];
+
+    if (!customer->in_use || customer->generation != seller->generation) {
+        // Customer gave up before being called
+        game_seller(sim->game, seller_id)->state = IDLE;
+        schedule(sim, SELLER_PAUSE, EV_SELLER_FREE, seller_id, 0);
+        return;
+    }
+
+    customer->called = 1;
+    customer->entry.state = ORDERING;
+    customer->entry.patience = customer->original_patience;
+    schedule(sim, CUSTOMER_ORDERING_TIME, EV_ORDER_PLACED, seller->customer, customer->generation);
+}
+
+static void handle_order_placed(Simulation *sim, int slot, int generation) {
+    SimCustomer *customer = &sim->customers[slot];
+    if (!customer->in_use || customer->generation != generation) {
+        return;
+    }
+
+    generate_random_customer_order(&customer->order, sim->game, &sim->rng);
+    customer->entry.state = WAITING_FOR_ORDER;
+
+    game_seller(sim->game, customer->seller)->state = PROCESSING_ORDER;
+    schedule(sim, SELLER_PROCESSING_TIME, EV_ORDER_FILLED, customer->seller, generation);
+}
+
+static void handle_order_filled(Simulation *sim, int seller_id) {
+    SimSeller *seller = &sim->sellers[seller_id];
+    SimCustomer *customer = &sim->customers[seller->customer];
+    Game *game = sim->game;
+
+    game_seller(game, seller_id)->state = COMPLETING_ORDER;
+
+    if (customer->in_use && customer->generation == seller->generation) {
+        if (check_and_fulfill_order(&game->ready_products, &customer->order)) {
+            stats_add_profit(&game->stats, customer->order.total_price);
+            leave_bakery(sim, seller->customer, customer->entry.state, LEAVING_NORMALLY);
+        } else {
+            leave_bakery(sim, seller->customer, MISSING_ORDER, LEAVING_EARLY);
+        }
+    }
+
+    game_seller(game, seller_id)->state = IDLE;
+    schedule(sim, SELLER_PAUSE, EV_SELLER_FREE, seller_id, 0);
+}
+
+
+/* ---------- chefs, bakers and ovens ---------------------------- */
+
+static void wake_idle_baker(Simulation *sim, Team team) {
+    for (int i = 0; i < sim->num_bakers; i++) {
+        Baker *baker = game_baker(sim->game, i);
+        if (baker->team_name == team && baker->state == BAKER_IDLE && !sim->bakers[i].scheduled) {
+            sim->bakers[i].scheduled = 1;
+            schedule(sim, 0, EV_BAKER_START, i, 0);
+            return;
+        }
+    }
+}
+
+static void handle_chef_start(Simulation *sim, int chef_id) {
+    Game *game = sim->game;
+    Chef *chef = game_chef(game, chef_id);
+    ChefTeam team = chef->team;
+
+    // The paste team has no catalog category of its own
+    if (team == TEAM_PASTE || game_product_count(game, team) == 0) {
+        schedule(sim, 1, EV_CHEF_START, chef_id, 0);
+        return;
+    }
+
+    int product_index = random_below(&sim->rng, game_product_count(game, team));
+    Product *product = game_product(game, team, product_index);
+
+    if (take_recipe_ingredients(&game->inventory, product)) {
+        strncpy(chef->Item, product->name, MAX_NAME_LENGTH - 1);
+        chef->Item[MAX_NAME_LENGTH - 1] = '\0';
+        chef->is_active = 1;
+
+        sim->chefs[chef_id].team = team;
+        sim->chefs[chef_id].product_index = product_index;
+        schedule(sim, product->preparation_time, EV_CHEF_DONE, chef_id, 0);
+    } else {
+        chef->is_active = 0;
+        schedule(sim, CHEF_RETRY_DELAY, EV_CHEF_START, chef_id, 0);
+    }
+}
+
+static void handle_chef_done(Simulation *sim, int chef_id) {
+    Game *game = sim->game;
+    SimChef *chef = &sim->chefs[chef_id];
+    const Product *product = game_product(game, chef->team, chef->product_index);
+
+    if (chef->team == TEAM_SANDWICHES) {
+        add_ready_product(&game->ready_products, get_product_type_for_team(chef->team),
+                          chef->product_index, 1);
+    } else {
+        // Items that need baking go to the matching baker team
+        ChefMessage job;
+        job.mtype = chef->team + 1;
+        job.source_team = chef->team;
+        job.product_index = chef->product_index;
+        strncpy(job.product_name, product->name, MAX_NAME_LENGTH - 1);
+        job.product_name[MAX_NAME_LENGTH - 1] = '\0';
+
+        Team baker_team = get_baker_team_from_chef_team(chef->team);
+        if (fifo_push(&sim->baker_jobs[baker_team], &job) == -1) {
+            fprintf(stderr, "Simulation: failed to queue baker job\n");
+            exit(EXIT_FAILURE);
+        }
+        wake_idle_baker(sim, baker_team);
+    }
+
+    schedule(sim, 0, EV_CHEF_START, chef_id, 0);
+}
+
+static void handle_baker_start(Simulation *sim, int baker_id) {
+    Game *game = sim->game;
+    Baker *baker = game_baker(game, baker_id);
+    SimBaker *state = &sim->bakers[baker_id];
+
+    if (fifo_pop(&sim->baker_jobs[baker->team_name], &state->job) == -1) {
+        state->scheduled = 0;  // Nothing to do, wait for the next chef item
+        return;
+    }
+
+    strncpy(baker->Item, state->job.product_name, MAX_NAME_LENGTH - 1);
+    baker->Item[MAX_NAME_LENGTH - 1] = '\0';
+
+    int prep = random_between(sim, game->config.MIN_BAKE_TIME, game->config.MAX_BAKE_TIME);
+    schedule(sim, prep, EV_BAKER_PREPARED, baker_id, 0);
+}
+
+static void handle_baker_prepared(Simulation *sim, int baker_id) {
+    Game *game = sim->game;
+    Baker *baker = game_baker(game, baker_id);
+    SimBaker *state = &sim->bakers[baker_id];
+
+    for (int i = 0; i < sim->num_ovens; i++) {
+        Oven *oven = game_oven(game, i);
+        if (oven->is_busy) {
+            continue;
+        }
+
+        int bake_time = random_between(sim, game->config.MIN_OVEN_TIME, game->config.MAX_OVEN_TIME);
+        oven->is_busy = 1;
+        oven->time_left = bake_time;
+        oven->ready_at = sim->now + bake_time;
+        strncpy(oven->item_name, state->job.product_name, sizeof(oven->item_name) - 1);
+        oven->item_name[sizeof(oven->item_name) - 1] = '\0';
+        strncpy(oven->team_name, get_team_name_str(baker->team_name), sizeof(oven->team_name) - 1);
+        oven->team_name[sizeof(oven->team_name) - 1] = '\0';
+
+        sim->oven_owner[i] = baker_id;
+        state->oven = i;
+        baker->state = BAKER_BUSY;
+        schedule(sim, bake_time, EV_OVEN_DONE, i, 0);
+        return;
+    }
+
+    // No oven free, retry as soon as one finishes
+    if (fifo_push(&sim->oven_waiters, &baker_id) == -1) {
+        fprintf(stderr, "Simulation: failed to queue oven waiter\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void handle_oven_done(Simulation *sim, int oven_id) {
+    Game *game = sim->game;
+    Oven *oven = game_oven(game, oven_id);
+    int baker_id = sim->oven_owner[oven_id];
+    SimBaker *state = &sim->bakers[baker_id];
+
+    oven->is_busy = 0;
+    oven->time_left = 0;
+    oven->item_name[0] = '\0';
+    oven->team_name[0] = '\0';
+    sim->oven_owner[oven_id] = -1;
+
+    add_ready_product(&game->ready_products, get_product_type_for_team(state->job.source_team),
+                      state->job.product_index, 1);
+
+    game_baker(game, baker_id)->state = BAKER_IDLE;
+    state->oven = -1;
+    schedule(sim, 0, EV_BAKER_START, baker_id, 0);
+
+    int waiter;
+    if (fifo_pop(&sim->oven_waiters, &waiter) == 0) {
+        schedule(sim, 0, EV_BAKER_PREPARED, waiter, 0);
+    }
+}
+
+
+/* ---------- supply chains -------------------------------------- */
+
+// Same scan as supply_chain_manager's process_supply_chain_messages
+static void handle_supply_check(Simulation *sim) {
+    Game *game = sim->game;
+    SimSupplyOrder order = {0};
+    int chain = random_below(&sim->rng, sim->num_supply_chains);
+
+    for (int i = 0; i < game->config.INGREDIENTS_TO_ORDER && order.count < NUM_INGREDIENTS; i++) {
+        int ingredient_type = random_below(&sim->rng, NUM_INGREDIENTS);
+        float current_quantity = get_ingredient(&game->inventory, ingredient_type);
+        float percentage = current_quantity * 100.0f / game->inventory.max_capacity;
+
+        if (percentage < 20.0f) {
+            float max_capacity = (float) game->inventory.max_capacity;
+            order.items[order.count].type = ingredient_type;
+            order.items[order.count].quantity = random_float(&sim->rng, 1.0f, max_capacity - current_quantity);
+            order.count++;
+        }
+    }
+
+    if (order.count > 0) {
+        SimSupplyChain *supply_chain = &sim->supply_chains[chain];
+        if (fifo_push(&supply_chain->orders, &order) == -1) {
+            fprintf(stderr, "Simulation: failed to queue supply order\n");
+            exit(EXIT_FAILURE);
+        }
+        if (!supply_chain->busy) {
+            supply_chain->busy = 1;
+            schedule(sim, 0, EV_SUPPLY_POLL, chain, 0);
+        }
+    }
+
+    schedule(sim, SUPPLY_CHECK_INTERVAL, EV_SUPPLY_CHECK, 0, 0);
+}
+
+static void handle_supply_poll(Simulation *sim, int chain) {
+    SimSupplyChain *supply_chain = &sim->supply_chains[chain];
+
+    if (fifo_pop(&supply_chain->orders, &supply_chain->current) == -1) {
+        supply_chain->busy = 0;
+        return;
+    }
+
+    int delay = random_int(&sim->rng, 3, 7);  // Like get_random_delay
+    schedule(sim, delay, EV_SUPPLY_DELIVERED, chain, 0);
+}
+
+static void handle_supply_delivered(Simulation *sim, int chain) {
+    Game *game = sim->game;
+    SimSupplyOrder *order = &sim->supply_chains[chain].current;
+
+    for (int i = 0; i < order->count; i++) {
+        add_ingredient(&game->inventory, order->items[i].type, order->items[i].quantity);
+    }
+
+    schedule(sim, SUPPLY_CHAIN_PAUSE, EV_SUPPLY_POLL, chain, 0);
+}
+
+
+/* ---------- setup ---------------------------------------------- */
+
+static int init_game_state(Game *game) {
+    game->elapsed_time = 0;
+    stats_reset(&game->stats);
+    game->complaining_customer_pid = 0;
+    game->last_complaint_time = 0;
+    game->recent_complaint = false;
+    init_inventory(&game->inventory);
+    if (game_reset_ready_products(game) == -1) {
+        return -1;
+    }
+    memset(&game->info, 0, sizeof(game->info));
+    // Every per-actor slot, they run from the chefs up to the oven timers
+    memset((char *) game + game->layout.chefs, 0, game->layout.oven_timers - game->layout.chefs);
+    return 0;
+}
+
+static int init_simulation(Simulation *sim, Game *game) {
+    Config *config = &game->config;
+
+    RandomStream rng = sim->rng;   // Seeded by the caller
+    memset(sim, 0, sizeof(*sim));
+    sim->rng = rng;
+    sim->game = game;
+    if (init_game_state(game) == -1) {
+        return -1;
+    }
+
+    if (event_queue_init(&sim->events, 256) == -1) {
+        return -1;
+    }
+
+    // Chefs, split between the teams like the chef manager does
+    int chefs_per_team[TEAM_COUNT] = {0};
+    distribute_chefs(config->NUM_CHEFS, chefs_per_team, &sim->rng);
+    for (int team = 0; team < TEAM_COUNT; team++) {
+        for (int i = 0; i < chefs_per_team[team] && sim->num_chefs < game->layout.chef_slots; i++) {
+            Chef *chef = game_chef(game, sim->num_chefs);
+            chef->id = sim->num_chefs;
+            chef->team = team;
+            chef->pid = 0;
+            chef->is_active = 1;
+            sim->num_chefs++;
+        }
+    }
+    game->info.chef_count = sim->num_chefs;
+
+    // Bakers, split between the teams like the baker manager does
+    BakerTeam teams[NUM_BAKERY_TEAMS];
+    distribute_bakers_locally(config, teams, &sim->rng);
+    for (int team = 0; team < NUM_BAKERY_TEAMS; team++) {
+        for (int i = 0; i < teams[team].number_of_bakers && sim->num_bakers < game->layout.baker_slots; i++) {
+            Baker *baker = game_baker(game, sim->num_bakers++);
+            baker->team_name = teams[team].team_name;
+            baker->state = BAKER_IDLE;
+        }
+    }
+
+    sim->num_ovens = game->layout.oven_slots;
+    for (int i = 0; i < sim->num_ovens; i++) {
+        init_oven(game_oven(game, i), i);
+    }
+
+    sim->num_sellers = game->layout.seller_slots;   // At least one, see game.c
+    for (int i = 0; i < sim->num_sellers; i++) {
+        game_seller(game, i)->id = i;
+        game_seller(game, i)->pid = 0;
+        game_seller(game, i)->state = IDLE;
+    }
+
+    sim->num_supply_chains = config->NUM_SUPPLY_CHAIN > 0 ? config->NUM_SUPPLY_CHAIN : 1;
+    sim->max_customers = config->MAX_CUSTOMERS > 0 ? config->MAX_CUSTOMERS : 0;
+
+    sim->chefs = calloc(sim->num_chefs > 0 ? sim->num_chefs : 1, sizeof(SimChef));
+    sim->bakers = calloc(sim->num_bakers > 0 ? sim->num_bakers : 1, sizeof(SimBaker));
+    sim->oven_owner = malloc((sim->num_ovens > 0 ? sim->num_ovens : 1) * sizeof(int));
+    sim->supply_chains = calloc(sim->num_supply_chains, sizeof(SimSupplyChain));
+    sim->sellers = calloc(sim->num_sellers, sizeof(SimSeller));
+    sim->customers = calloc(sim->max_customers > 0 ? sim->max_customers : 1, sizeof(SimCustomer));
+    if (!sim->chefs || !sim->bakers || !sim->oven_owner || !sim->supply_chains || !sim->sellers || !sim->customers) {
+        perror("Simulation: failed to allocate actors");
+        return -1;
+    }
+
+    for (int i = 0; i < sim->num_ovens; i++) {
+        sim->oven_owner[i] = -1;
+    }
+    for (int i = 0; i < sim->num_bakers; i++) {
+        sim->bakers[i].oven = -1;
+    }
+
+    if (fifo_init(&sim->oven_waiters, sizeof(int), 16) == -1 ||
+        fifo_init(&sim->line, sizeof(LineEntry), 64) == -1) {
+        perror("Simulation: failed to allocate queues");
+        return -1;
+    }
+    for (int team = 0; team < NUM_BAKERY_TEAMS; team++) {
+        if (fifo_init(&sim->baker_jobs[team], sizeof(ChefMessage), 16) == -1) {
+            perror("Simulation: failed to allocate baker queues");
+            return -1;
+        }
+    }
+    for (int i = 0; i < sim->num_supply_chains; i++) {
+        if (fifo_init(&sim->supply_chains[i].orders, sizeof(SimSupplyOrder), 4) == -1) {
+            perror("Simulation: failed to allocate supply queues");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void destroy_simulation(Simulation *sim) {
+    for (int team = 0; team < NUM_BAKERY_TEAMS; team++) {
+        fifo_destroy(&sim->baker_jobs[team]);
+    }
+    if (sim->supply_chains) {
+        for (int i = 0; i < sim->num_supply_chains; i++) {
+            fifo_destroy(&sim->supply_chains[i].orders);
+        }
+    }
+    fifo_destroy(&sim->oven_waiters);
+    fifo_destroy(&sim->line);
+
+    free(sim->chefs);
+    free(sim->bakers);
+    free(sim->oven_owner);
+    free(sim->supply_chains);
+    free(sim->sellers);
+    free(sim->customers);
+
+    event_queue_destroy(&sim->events);
+    shared_mutex_destroy(&sim->game->ready_products.lock);
+}
+
+
+int run_headless_simulation(Game *game, unsigned int seed, SimStats *stats) {
+    Simulation sim;
+
+    random_stream_init(&sim.rng, seed, RANDOM_SIMULATION, 0);
+
+    if (init_simulation(&sim, game) == -1) {
+        destroy_simulation(&sim);
+        return -1;
+    }
+
+    // Initial events: every actor starts at t = 0
+    schedule(&sim, TICK_INTERVAL, EV_TICK, 0, 0);
+    schedule(&sim, 0, EV_SUPPLY_CHECK, 0, 0);
+    if (game->config.REALLOCATION_CHECK_INTERVAL > 0) {
+        schedule(&sim, game->config.REALLOCATION_CHECK_INTERVAL, EV_REBALANCE, 0, 0);
+    }
+    for (int i = 0; i < sim.num_chefs; i++) {
+        schedule(&sim, 0, EV_CHEF_START, i, 0);
+    }
+    for (int i = 0; i < sim.num_bakers; i++) {
+        sim.bakers[i].scheduled = 1;
+        schedule(&sim, 0, EV_BAKER_START, i, 0);
+    }
+
+    long processed = 0;
+    SimEvent event;
+
+    while (check_game_conditions(game) && event_queue_pop(&sim.events, &event) == 0) {
+        sim.now = event.time;
+        processed++;
+
+        switch (event.type) {
+            case EV_TICK:
+                handle_tick(&sim);
+                break;
+            case EV_SUPPLY_CHECK:
+                handle_supply_check(&sim);
+                break;
+            case EV_SUPPLY_POLL:
+                handle_supply_poll(&sim, event.actor);
+                break;
+            case EV_SUPPLY_DELIVERED:
+                handle_supply_delivered(&sim, event.actor);
+                break;
+            case EV_REBALANCE:
+                balance_teams(game);
+                schedule(&sim, game->config.REALLOCATION_CHECK_INTERVAL, EV_REBALANCE, 0, 0);
+                break;
+            case EV_CHEF_START:
+                handle_chef_start(&sim, event.actor);
+                break;
+            case EV_CHEF_DONE:
+                handle_chef_done(&sim, event.actor);
+                break;
+            case EV_BAKER_START:
+                handle_baker_start(&sim, event.actor);
+                break;
+            case EV_BAKER_PREPARED:
+                handle_baker_prepared(&sim, event.actor);
+                break;
+            case EV_OVEN_DONE:
+                handle_oven_done(&sim, event.actor);
+                break;
+            case EV_CUSTOMER_ARRIVED: {
+                SimCustomer *customer = &sim.customers[event.actor];
+                if (customer->in_use && customer->generation == event.data && customer->entry.state == WALKING) {
+                    customer->entry.state = WAITING_IN_QUEUE;
+                }
+                break;
+            }
+            case EV_SELLER_FREE:
+                handle_seller_free(&sim, event.actor);
+                break;
+            case EV_SELLER_CALL:
+                handle_seller_call(&sim, event.actor);
+                break;
+            case EV_ORDER_PLACED:
+                handle_order_placed(&sim, event.actor, event.data);
+                break;
+            case EV_ORDER_FILLED:
+                handle_order_filled(&sim, event.actor);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (stats) {
+        stats->events_processed = processed;
+        stats->simulated_time = sim.now;
+    }
+
+    destroy_simulation(&sim);
+    return 0;
+}
@@ -6,7 +6,6 @@
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <time.h>
-#include <math.h>
 
 #include "game.h"
 #include "supply_chain.h"
@@ -15,94 +14,31 @@
 #include "random.h"
 #include "products.h"
 
-// Define message queue key
-#define SUPPLY_CHAIN_MSG_KEY 0x1234
-
 // Global variables
 Game* shared_game = NULL;
-sem_t* inventory_sem = NULL;
 int supply_chain_id = -1;
 int msg_queue_id = -1;
+ShmArena* arena = NULL;
 
 // Signal handler for cleanup
 void handle_signal(int sig) {
     printf("Supply Chain %d: Shutting down...\n", supply_chain_id);
     
     // Cleanup resources
+    shm_arena_unmap(arena);
     if (shared_game != NULL) {
-        munmap(shared_game, sizeof(Game));
+        unmap_shared_game(shared_game);
     }
     
     exit(EXIT_SUCCESS);
 }
 
-// Function to generate random delay between deliveries
-int get_random_delay() {
-    return (rand() % 5) + 3; // 3 to 7 seconds
-}
-
-// Function to generate random quantity of ingredients
-int get_random_quantity() {
-    return (rand() % 10) + 5; // 5 to 14 units
-}
-
-
-
-// Function to update inventory based on supply chain type
-void update_inventory() {
-    
-    SupplyChainMessage* msg;
-    msg = malloc(sizeof(SupplyChainMessage) + sizeof(Ingredient) * shared_game->config.INGREDIENTS_TO_ORDER);
-    if (msg == NULL) {
-        perror("Failed to allocate memory for message");
-        return;
-    }
-    int result = msgrcv(msg_queue_id, msg, sizeof(SupplyChainMessage) + sizeof(Ingredient) * shared_game->config.INGREDIENTS_TO_ORDER  - sizeof(long), getpid(), IPC_NOWAIT);
-
-    if(result == -1) {
-        return;
-    }
-
-
-    // Simulate delivery time
-    int time = get_random_delay();
-    printf("Supply Chain %d: delivering after %d seconds\n", getpid(), time);
-    sleep(time);
-    printf("Supply Chain %d: putting in inventory\n", getpid());
-    
-    
-    // Lock inventory for update
-    lock_inventory(inventory_sem);
-
-    printf("Supply Chain %d: Accessed inventory:\n", getpid());
-    
-    // Update inventory in shared memory
-    for (int i = 0; i < shared_game->config.INGREDIENTS_TO_ORDER; i++)
-    {
-        // Update the inventory in shared memory 
-
-        int type = msg->ingredients[i].type;
-        shared_game->inventory.quantities[type] = 
-        fmin(shared_game->inventory.quantities[type] + msg->ingredients[i].quantity,
-             (float)shared_game->inventory.max_capacity);
-           
-        printf("Supply Chain %d: Updated inventory for ingredient %d: %.1f\n", 
-               getpid(), i, shared_game->inventory.quantities[type]);
+int main(int argc, char *argv[]) {
+    // The manager passes the chain index
+    if (argc > 1) {
+        supply_chain_id = atoi(argv[1]);
     }
 
-    unlock_inventory(inventory_sem);
-
-    print_inventory(&shared_game->inventory);
-
-    free(msg);
-
-    fflush(stdout);
-    
-}
-
-int main(int argc, char *argv[]) {
-  
-    
     // Setup shared memory
     setup_shared_memory(&shared_game);
     if (shared_game == NULL) {
@@ -110,13 +46,14 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
     
-    // Setup semaphores
-    inventory_sem = setup_inventory_semaphore();
-    if (inventory_sem == NULL) {
-        fprintf(stderr, "Supply Chain %d: Failed to setup inventory semaphore\n", supply_chain_id);
+    // Orders arrive as refs into the bakery arena
+    arena = shm_arena_map(BAKERY_ARENA_SHM_NAME);
+    if (arena == NULL) {
         return EXIT_FAILURE;
     }
-    
+
+    // Deliveries are lock-free atomic adds, no inventory semaphore needed
+
     // Create or get message queue
     msg_queue_id = msgget(SUPPLY_CHAIN_MSG_KEY, 0666 | IPC_CREAT);
     if (msg_queue_id == -1) {
@@ -124,15 +61,17 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
     
-    
+    RandomStream rng;
+    random_stream_init(&rng, shared_game->config.SEED, RANDOM_SUPPLY_CHAIN, supply_chain_id);
+
     // Main loop
     while (1) {
         // Random delay between deliveries
         
         
         // Update inventory with new supplies
-        update_inventory();
-        sleep(1);
+        deliver_supplies(shared_game, arena, msg_queue_id, getpid(), &rng);
+        sim_sleep(&shared_game->clock, 1);
     }
     
     return EXIT_SUCCESS;
@@ -19,13 +19,12 @@
 #include <sys/ipc.h>
 #include <errno.h>
 
-// Define message queue key (must match the one in supply_chain.c)
-#define SUPPLY_CHAIN_MSG_KEY 0x1234
-
 // Global variables
 Game* shared_game = NULL;
 int msg_queue_id = -1;
+ShmArena* arena = NULL;
 pid_t* supply_chain_pids = NULL;
+long* supply_chain_mtypes = NULL;  // Orders are addressed to each chain's pid
 
 // Function prototypes
 void cleanup_supply_chain_resources(void);
@@ -46,6 +45,7 @@ void cleanup_supply_chain_resources() {
             }
         }
         free(supply_chain_pids);
+        free(supply_chain_mtypes);
     }
     
     // Remove message queue
@@ -53,69 +53,21 @@ void cleanup_supply_chain_resources() {
         msgctl(msg_queue_id, IPC_RMID, NULL);
     }
     
+    shm_arena_unmap(arena);
+
         if (shared_game != NULL) {
-        munmap(shared_game, sizeof(Game));
-        shm_unlink("/game_shared_mem");
+        unmap_shared_game(shared_game);
+        shm_unlink(GAME_SHM_NAME);
     }
 }
 
 
 
-// Function to process messages from supply chains
-void process_supply_chain_messages(sem_t* inventory_sem) {
-    SupplyChainMessage* msg;
-    msg = malloc(sizeof(SupplyChainMessage) + sizeof(Ingredient) * shared_game->config.INGREDIENTS_TO_ORDER);
-    if (msg == NULL) {
-        perror("Failed to allocate memory for SupplyChainMessage");
-        return;
-    }
-    int pid_index = rand() % shared_game->config.NUM_SUPPLY_CHAIN;
-
-    printf("Supply Chain Manager: Processing messages from supply chain %d\n", pid_index);
-
-    lock_inventory(inventory_sem);
-
-    printf("Supply Chain Manager: Accessed inventory:\n");
-
-    for(int i = 0; i < shared_game->config.INGREDIENTS_TO_ORDER; i++) {
-        int ingredient_type = rand() % NUM_INGREDIENTS;
-        // calculate percentage of this ingredient
-        float percentage = shared_game->inventory.quantities[ingredient_type] * 100.0f / shared_game->inventory.max_capacity;
-
-        if(percentage < 20.0f) {
-            // Send message to supply chain
-            
-            msg->mtype = supply_chain_pids[pid_index];
-            msg->ingredients[i].type = ingredient_type;
-            float current_quantity = shared_game->inventory.quantities[ingredient_type];
-            float max_capacity = (float)shared_game->inventory.max_capacity;
-            float to_order = random_float(1.0f, max_capacity - current_quantity); // Random quantity to order
-            msg->ingredients[i].quantity = to_order;
-
-            printf("Supply Chain Manager: Ordering %.1f of %s\n", 
-                   to_order, get_ingredient_name(ingredient_type));   
-        
-        }
-    }
-
-    unlock_inventory(inventory_sem);
-
-    if (msgsnd(msg_queue_id, msg, sizeof(SupplyChainMessage) + sizeof(Ingredient) * shared_game->config.INGREDIENTS_TO_ORDER  - sizeof(long), IPC_NOWAIT) == -1) {
-        perror("Failed to send message to supply chain");
-    } else {
-        printf("Supply Chain Manager: Sent order to supply chain %d\n", supply_chain_pids[pid_index]);
-    }
-
-    free(msg);
-
-    fflush(stdout);  
-
-}
-
 void fork_supply_chain_process() {
     // Allocate memory for supply chain PIDs
     supply_chain_pids = malloc(sizeof(pid_t) * shared_game->config.NUM_SUPPLY_CHAIN);
-    if (supply_chain_pids == NULL) {
+    supply_chain_mtypes = malloc(sizeof(long) * shared_game->config.NUM_SUPPLY_CHAIN);
+    if (supply_chain_pids == NULL || supply_chain_mtypes == NULL) {
         perror("Failed to allocate memory for supply chain PIDs");
         exit(EXIT_FAILURE);
     }
@@ -133,6 +85,7 @@ void fork_supply_chain_process() {
         } else if (supply_chain_pids[i] < 0) {
             perror("Failed to fork supply chain process");
         } else {
+            supply_chain_mtypes[i] = supply_chain_pids[i];
             const char* ingredient_name = get_ingredient_name(i);
             printf("Supply Chain Manager: Started supply chain %d (%s) with PID %d\n", 
                    i, ingredient_name, supply_chain_pids[i]);
@@ -145,29 +98,28 @@ int main(int argc, char *argv[]) {
     signal(SIGINT, handle_sigint);
     signal(SIGTERM, handle_sigint);
 
-    // Setup shared memory and semaphores
+    // Setup shared memory
     setup_shared_memory(&shared_game);
-    sem_t* inventory_sem = setup_inventory_semaphore();
-    sem_t* ready_products_sem = setup_ready_products_semaphore();
 
     // Register cleanup handler
     atexit(cleanup_supply_chain_resources);
     
-    // Initialize random number generator
-    init_random();
-
     // Check if shared memory was created successfully
     if (shared_game == NULL) {
         fprintf(stderr, "Failed to setup shared memory\n");
         return 1;
     }
 
-    // Check if semaphores were created successfully
-    if (inventory_sem == NULL || ready_products_sem == NULL) {
-        fprintf(stderr, "Failed to setup semaphores\n");
+    // Orders are written into the bakery arena and sent by ref
+    arena = shm_arena_map(BAKERY_ARENA_SHM_NAME);
+    if (arena == NULL) {
         return 1;
     }
-    
+
+    // Orders draw from the manager's own stream
+    RandomStream rng;
+    random_stream_init(&rng, shared_game->config.SEED, RANDOM_SUPPLY_MANAGER, 0);
+
     // Create message queue
     msg_queue_id = msgget(SUPPLY_CHAIN_MSG_KEY, 0666 | IPC_CREAT);
     if (msg_queue_id == -1) {
@@ -186,9 +138,10 @@ int main(int argc, char *argv[]) {
     // Main loop for supply chain manager
     while(1) {
         // Process messages from supply chains
-        process_supply_chain_messages(inventory_sem);
+        request_supplies(shared_game, arena, msg_queue_id,
+                         supply_chain_mtypes, shared_game->config.NUM_SUPPLY_CHAIN, &rng);
         
-        sleep(2); // Sleep for a while before processing again
+        sim_sleep(&shared_game->clock, 2); // Sleep for a while before processing again
     }
 
     return 0;
@@ -0,0 +1,119 @@
+//
+// Ordering and delivery logic shared by the supply chain processes and the
+// threaded runtime. Chains are addressed by mtype: their pid as processes,
+// their index as threads.
+//
+
+#include <stdio.h>
+#include <errno.h>
+#include <sys/msg.h>
+
+#include "game.h"
+#include "supply_chain.h"
+#include "semaphores_utils.h"
+#include "random.h"
+
+// Function to generate random delay between deliveries
+static int get_random_delay(RandomStream *rng) {
+    return random_int(rng, 3, 7); // 3 to 7 seconds
+}
+
+// The queue only carries refs; stop ordering once the chains fall behind
+// instead of filling the arena with orders nobody delivers yet
+static int chains_behind(int msg_queue_id, int num_chains) {
+    struct msqid_ds info;
+    return msgctl(msg_queue_id, IPC_STAT, &info) == 0 &&
+           info.msg_qnum >= (msgqnum_t) num_chains * SUPPLY_ORDERS_PER_CHAIN;
+}
+
+void request_supplies(Game *game, ShmArena *arena, int msg_queue_id,
+                      const long *chain_mtypes, int num_chains, RandomStream *rng) {
+    if (chains_behind(msg_queue_id, num_chains)) {
+        return;
+    }
+
+    SupplyChainMessage msg;
+    msg.order = shm_arena_alloc(arena, supply_order_size(game->config.INGREDIENTS_TO_ORDER));
+    SupplyOrder *order = shm_arena_ptr(arena, msg.order);
+    if (order == NULL) {
+        fprintf(stderr, "Supply Chain Manager: No arena space for an order\n");
+        return;
+    }
+    int chain_index = random_below(rng, num_chains);
+    int ordered = 0;
+
+    msg.mtype = chain_mtypes[chain_index];
+    order->count = game->config.INGREDIENTS_TO_ORDER;
+
+    printf("Supply Chain Manager: Processing messages from supply chain %d\n", chain_index);
+
+    // Plain atomic reads: an order placed on a slightly stale level is harmless
+    for (int i = 0; i < order->count; i++) {
+        int ingredient_type = random_below(rng, NUM_INGREDIENTS);
+        // Unused slots are sent as empty orders
+        order->ingredients[i].type = ingredient_type;
+        order->ingredients[i].quantity = 0;
+
+        // calculate percentage of this ingredient
+        float current_quantity = get_ingredient(&game->inventory, ingredient_type);
+        float percentage = current_quantity * 100.0f / game->inventory.max_capacity;
+
+        if (percentage < 20.0f) {
+            float max_capacity = (float) game->inventory.max_capacity;
+            float to_order = random_float(rng, 1.0f, max_capacity - current_quantity); // Random quantity to order
+            order->ingredients[i].quantity = to_order;
+            ordered++;
+
+            printf("Supply Chain Manager: Ordering %.1f of %s\n",
+                   to_order, get_ingredient_name(ingredient_type));
+        }
+    }
+
+    // The chain owns the order once it is sent
+    if (ordered == 0) {
+        shm_arena_free(arena, msg.order);
+    } else if (msgsnd(msg_queue_id, &msg, sizeof(msg) - sizeof(long), IPC_NOWAIT) == -1) {
+        perror("Failed to send message to supply chain");
+        shm_arena_free(arena, msg.order);
+    } else {
+        printf("Supply Chain Manager: Sent order to supply chain %ld\n", msg.mtype);
+    }
+
+    fflush(stdout);
+}
+
+int deliver_supplies(Game *game, ShmArena *arena, int msg_queue_id, long mtype, RandomStream *rng) {
+    SupplyChainMessage msg;
+
+    if (msgrcv(msg_queue_id, &msg, sizeof(msg) - sizeof(long), mtype, IPC_NOWAIT) == -1) {
+        return errno == EIDRM || errno == EINVAL ? -1 : 0;
+    }
+    SupplyOrder *order = shm_arena_ptr(arena, msg.order);
+    if (order == NULL) {
+        return 0;
+    }
+
+    // Simulate delivery time
+    int time = get_random_delay(rng);
+    printf("Supply Chain %ld: delivering after %d seconds\n", mtype, time);
+    sim_sleep(&game->clock, time);
+    printf("Supply Chain %ld: putting in inventory\n", mtype);
+
+    // Each ingredient is one atomic add, capped at the capacity
+    for (int i = 0; i < order->count; i++) {
+        int type = order->ingredients[i].type;
+        if (order->ingredients[i].quantity <= 0) {
+            continue;
+        }
+        float updated = add_ingredient(&game->inventory, type, order->ingredients[i].quantity);
+
+        printf("Supply Chain %ld: Updated inventory for ingredient %d: %.1f\n",
+               mtype, i, updated);
+    }
+
+    print_inventory(&game->inventory);
+
+    shm_arena_free(arena, msg.order);
+    fflush(stdout);
+    return 1;
+}
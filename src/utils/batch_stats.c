@@ -0,0 +1,61 @@
+#include <math.h>
+#include <stdlib.h>
+#include "batch_stats.h"
+
+// Two-sided 95% Student t quantiles for 1..30 degrees of freedom
+static const double t_quantile_95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double t_quantile(int degrees) {
+    if (degrees <= 30) {
+        return t_quantile_95[degrees - 1];
+    }
+    return 1.96;  // Close enough to the normal quantile past 30
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *) a;
+    double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+double percentile_sorted(const double *values, int n, double p) {
+    double rank = p / 100.0 * (n - 1);
+    int lower = (int) rank;
+    if (lower >= n - 1) {
+        return values[n - 1];
+    }
+    double fraction = rank - lower;
+    return values[lower] + fraction * (values[lower + 1] - values[lower]);
+}
+
+void summarize_values(double *values, int n, BatchSummary *summary) {
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += values[i];
+    }
+    double mean = sum / n;
+
+    double squares = 0;
+    for (int i = 0; i < n; i++) {
+        squares += (values[i] - mean) * (values[i] - mean);
+    }
+
+    summary->n = n;
+    summary->mean = mean;
+    summary->stddev = n > 1 ? sqrt(squares / (n - 1)) : 0;
+
+    double half_width = n > 1 ? t_quantile(n - 1) * summary->stddev / sqrt(n) : 0;
+    summary->ci_low = mean - half_width;
+    summary->ci_high = mean + half_width;
+
+    qsort(values, n, sizeof(double), compare_doubles);
+    summary->min = values[0];
+    summary->p5 = percentile_sorted(values, n, 5);
+    summary->p50 = percentile_sorted(values, n, 50);
+    summary->p95 = percentile_sorted(values, n, 95);
+    summary->max = values[n - 1];
+}
@@ -0,0 +1,141 @@
+//
+// Shared-memory message channels, see channel.h.
+//
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "channel.h"
+#include "coroutine.h"
+#include "futex_utils.h"
+
+static size_t ring_stride(uint32_t capacity, uint32_t msg_size) {
+    size_t size = mpmc_ring_size(msg_size, capacity);
+    return (size + CACHE_LINE - 1) & ~((size_t) CACHE_LINE - 1);
+}
+
+static MpmcRing *channel_ring(ChannelSet *set, int channel) {
+    return (MpmcRing *) (set->rings + (size_t) channel * ring_stride(set->capacity, set->msg_size));
+}
+
+static int is_closed(const ChannelSet *set) {
+    return __atomic_load_n(&set->closed, __ATOMIC_ACQUIRE) != 0;
+}
+
+// Sleep until *word moves on from seen; parks the coroutine instead inside one
+static void wait_on(uint32_t *word, uint32_t seen, uint32_t *waiters) {
+    __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+    coro_futex_wait(word, seen);
+    __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+}
+
+size_t channel_set_size(int count, uint32_t capacity, uint32_t msg_size) {
+    return sizeof(ChannelSet) + (size_t) count * ring_stride(mpmc_ring_capacity(capacity), msg_size);
+}
+
+ChannelSet *channel_set_open(const char *name, int count, uint32_t capacity, uint32_t msg_size, int init) {
+    capacity = mpmc_ring_capacity(capacity);
+    size_t size = channel_set_size(count, capacity, msg_size);
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0666);
+    if (fd == -1) {
+        perror("Failed to open channel shared memory");
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t) size) == -1) {
+        perror("Failed to size channel shared memory");
+        close(fd);
+        return NULL;
+    }
+
+    ChannelSet *set = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (set == MAP_FAILED) {
+        perror("Failed to map channel shared memory");
+        return NULL;
+    }
+
+    if (init) {
+        memset(set, 0, size);
+        set->count = count;
+        set->capacity = capacity;
+        set->msg_size = msg_size;
+        for (int i = 0; i < count; i++) {
+            mpmc_ring_init(channel_ring(set, i), msg_size, capacity);
+        }
+    }
+    return set;
+}
+
+void channel_set_unmap(ChannelSet *set) {
+    if (set == NULL) {
+        return;
+    }
+    if (munmap(set, channel_set_size(set->count, set->capacity, set->msg_size)) == -1) {
+        perror("munmap failed");
+    }
+}
+
+void channel_set_shutdown(ChannelSet *set) {
+    __atomic_store_n(&set->closed, 1, __ATOMIC_RELEASE);
+
+    // Move every futex word on so no sleeper can miss the flag
+    for (uint32_t i = 0; i < set->count; i++) {
+        MpmcRing *ring = channel_ring(set, (int) i);
+        __atomic_add_fetch(&ring->items, 1, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&ring->slots, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&ring->items, INT_MAX);
+        futex_wake(&ring->slots, INT_MAX);
+    }
+}
+
+int channel_send(ChannelSet *set, int channel, const void *msg) {
+    MpmcRing *ring = channel_ring(set, channel);
+
+    for (;;) {
+        uint32_t seen = __atomic_load_n(&ring->slots, __ATOMIC_SEQ_CST);
+        if (is_closed(set)) {
+            return -1;
+        }
+        if (mpmc_ring_push(ring, msg) == 0) {
+            return 0;
+        }
+        wait_on(&ring->slots, seen, &ring->slot_waiters);
+    }
+}
+
+int channel_recv(ChannelSet *set, int channel, void *msg) {
+    MpmcRing *ring = channel_ring(set, channel);
+
+    for (;;) {
+        uint32_t seen = __atomic_load_n(&ring->items, __ATOMIC_SEQ_CST);
+        if (is_closed(set)) {
+            return -1;
+        }
+        if (mpmc_ring_pop(ring, msg) == 0) {
+            return 0;
+        }
+        wait_on(&ring->items, seen, &ring->waiters);
+    }
+}
+
+int channel_try_recv(ChannelSet *set, int channel, void *msg) {
+    if (is_closed(set)) {
+        return -1;
+    }
+    return mpmc_ring_pop(channel_ring(set, channel), msg);
+}
+
+uint32_t channel_waiting_receivers(ChannelSet *set, int channel) {
+    return __atomic_load_n(&channel_ring(set, channel)->waiters, __ATOMIC_RELAXED);
+}
+
+int channel_recv_timeout(ChannelSet *set, int channel, void *msg, const struct timespec *timeout) {
+    if (is_closed(set)) {
+        return -1;
+    }
+    return mpmc_ring_pop_wait(channel_ring(set, channel), msg, timeout);
+}
@@ -2,6 +2,50 @@
 #include <json-c/json.h>
 #include "products.h"
 
+// Set one config field by its key; -1 when the key is unknown
+int set_config_value(Config *config, const char *key, double value) {
+    if (strcmp(key, "FRUSTRATED_CUSTOMERS") == 0) config->FRUSTRATED_CUSTOMERS = (int)value;
+    else if (strcmp(key, "MAX_CUSTOMERS") == 0) config->MAX_CUSTOMERS = (int) value;
+    else if (strcmp(key, "MAX_TIME") == 0) config->MAX_TIME = (int)value;
+    else if (strcmp(key, "COMPLAINED_CUSTOMERS") == 0) config->COMPLAINED_CUSTOMERS = (int)value;
+    else if (strcmp(key, "CUSTOMERS_MISSING") == 0) config->CUSTOMERS_MISSING = (int)value;
+    else if (strcmp(key, "DAILY_PROFIT") == 0) config->DAILY_PROFIT = value;
+    else if (strcmp(key, "NUM_CHEFS") == 0) config->NUM_CHEFS = (int)value;
+    else if (strcmp(key, "NUM_BAKERS") == 0) config->NUM_BAKERS = (int)value;
+    else if (strcmp(key, "NUM_SELLERS") == 0) config->NUM_SELLERS = (int)value;
+    else if (strcmp(key, "NUM_SUPPLY_CHAIN") == 0) config->NUM_SUPPLY_CHAIN = (int)value;
+    else if (strcmp(key, "MIN_PURCHASE_QUANTITY") == 0) config->MIN_PURCHASE_QUANTITY = (int)value;
+    else if (strcmp(key, "MAX_PURCHASE_QUANTITY") == 0) config->MAX_PURCHASE_QUANTITY = (int)value;
+    else if (strcmp(key, "MIN_TIME_FRUSTRATED") == 0) config->MIN_TIME_FRUSTRATED = (int)value;
+    else if (strcmp(key, "MAX_TIME_FRUSTRATED") == 0) config->MAX_TIME_FRUSTRATED = (int)value;
+    else if (strcmp(key, "MIN_OVEN_TIME") == 0) config->MIN_OVEN_TIME = (int)value;
+    else if (strcmp(key, "MAX_OVEN_TIME") == 0) config->MAX_OVEN_TIME = (int)value;
+    else if (strcmp(key, "MAX_PATIENCE") == 0) config->MAX_PATIENCE = value;
+    else if (strcmp(key, "MIN_PATIENCE") == 0) config->MIN_PATIENCE = value;
+    else if (strcmp(key, "MAX_PATIENCE_DECAY") == 0) config->MAX_PATIENCE_DECAY = value;
+    else if (strcmp(key, "MIN_PATIENCE_DECAY") == 0) config->MIN_PATIENCE_DECAY = value;
+    else if (strcmp(key, "NUM_OVENS") == 0) config->NUM_OVENS = (int)value;
+    else if (strcmp(key, "MIN_BAKE_TIME") == 0) config->MIN_BAKE_TIME = (int)value;
+    else if (strcmp(key, "MAX_BAKE_TIME") == 0) config->MAX_BAKE_TIME = (int)value;
+    else if (strcmp(key, "CUSTOMER_PROBABILITY") == 0) config->CUSTOMER_PROBABILITY = value;
+    else if (strcmp(key, "MIN_ORDER_ITEMS") == 0) config->MIN_ORDER_ITEMS = (int)value;
+    else if (strcmp(key, "MAX_ORDER_ITEMS") == 0) config->MAX_ORDER_ITEMS = (int)value;
+    else if (strcmp(key, "CUSTOMER_CASCADE_PROBABILITY") == 0) config->CUSTOMER_CASCADE_PROBABILITY = value;
+    else if (strcmp(key, "CASCADE_WINDOW") == 0) config->CASCADE_WINDOW = (int)value;
+    else if (strcmp(key, "REALLOCATION_CHECK_INTERVAL") == 0) config->REALLOCATION_CHECK_INTERVAL = (int)value;
+    else if (strcmp(key, "PRODUCTION_RATIO_THRESHOLD") == 0) config->PRODUCTION_RATIO_THRESHOLD = value;
+    else if (strcmp(key, "MIN_CHEFS_PER_TEAM") == 0) config->MIN_CHEFS_PER_TEAM = (int)value;
+    else if (strcmp(key, "MIN_SELLER_PROCESSING_TIME") == 0) config->MIN_SELLER_PROCESSING_TIME = (int)value;
+    else if (strcmp(key, "MAX_SELLER_PROCESSING_TIME") == 0) config->MAX_SELLER_PROCESSING_TIME = (int)value;
+    else if (strcmp(key, "INGREDIENTS_TO_ORDER") == 0) config->INGREDIENTS_TO_ORDER = (int)value;
+    else if (strcmp(key, "TIME_SCALE") == 0) config->TIME_SCALE = value;
+    else if (strcmp(key, "SEED") == 0) config->SEED = (unsigned int) value;
+    else if (strcmp(key, "SELLER_WINDOW") == 0) config->SELLER_WINDOW = (int)value;
+    else if (strcmp(key, "PRODUCT_WAIT") == 0) config->PRODUCT_WAIT = value;
+    else return -1;
+    return 0;
+}
+
 // Function to load configuration settings from a specified file
 int load_config(const char *filename, Config *config) {
     // Attempt to open the config file in read mode
@@ -46,6 +90,10 @@ int load_config(const char *filename, Config *config) {
     config->PRODUCTION_RATIO_THRESHOLD = -1;
     config->MIN_CHEFS_PER_TEAM = -1;
     config->INGREDIENTS_TO_ORDER = -1;
+    config->TIME_SCALE = 1.0f;  // Optional key, real time by default
+    config->SEED = 0;           // Optional key, a new seed every run by default
+    config->SELLER_WINDOW = 1;  // Optional key, one customer at a time by default
+    config->PRODUCT_WAIT = 0;   // Optional key, a short order goes missing at once by default
 
     // Buffer to hold each line from the configuration file
     char line[256];
@@ -55,46 +103,10 @@ int load_config(const char *filename, Config *config) {
 
         // Parse each line as a key-value pair
         char key[50];
-        float value;
-        if (sscanf(line, "%40[^=]=%f", key, &value) == 2) {
-
-            // Set corresponding config fields based on the key
-            if (strcmp(key, "FRUSTRATED_CUSTOMERS") == 0) config->FRUSTRATED_CUSTOMERS = (int)value;
-            else if (strcmp(key, "MAX_CUSTOMERS") == 0) config->MAX_CUSTOMERS = (int) value;
-            else if (strcmp(key, "MAX_TIME") == 0) config->MAX_TIME = (int)value;
-            else if (strcmp(key, "COMPLAINED_CUSTOMERS") == 0) config->COMPLAINED_CUSTOMERS = (int)value;
-            else if (strcmp(key, "CUSTOMERS_MISSING") == 0) config->CUSTOMERS_MISSING = (int)value;
-            else if (strcmp(key, "DAILY_PROFIT") == 0) config->DAILY_PROFIT = value;
-            else if (strcmp(key, "NUM_CHEFS") == 0) config->NUM_CHEFS = (int)value;
-            else if (strcmp(key, "NUM_BAKERS") == 0) config->NUM_BAKERS = (int)value;
-            else if (strcmp(key, "NUM_SELLERS") == 0) config->NUM_SELLERS = (int)value;
-            else if (strcmp(key, "NUM_SUPPLY_CHAIN") == 0) config->NUM_SUPPLY_CHAIN = (int)value;
-            else if (strcmp(key, "MIN_PURCHASE_QUANTITY") == 0) config->MIN_PURCHASE_QUANTITY = (int)value;
-            else if (strcmp(key, "MAX_PURCHASE_QUANTITY") == 0) config->MAX_PURCHASE_QUANTITY = (int)value;
-            else if (strcmp(key, "MIN_TIME_FRUSTRATED") == 0) config->MIN_TIME_FRUSTRATED = (int)value;
-            else if (strcmp(key, "MAX_TIME_FRUSTRATED") == 0) config->MAX_TIME_FRUSTRATED = (int)value;
-            else if (strcmp(key, "MIN_OVEN_TIME") == 0) config->MIN_OVEN_TIME = (int)value;
-            else if (strcmp(key, "MAX_OVEN_TIME") == 0) config->MAX_OVEN_TIME = (int)value;
-            else if (strcmp(key, "MAX_PATIENCE") == 0) config->MAX_PATIENCE = value;
-            else if (strcmp(key, "MIN_PATIENCE") == 0) config->MIN_PATIENCE = value;
-            else if (strcmp(key, "MAX_PATIENCE_DECAY") == 0) config->MAX_PATIENCE_DECAY = value;
-            else if (strcmp(key, "MIN_PATIENCE_DECAY") == 0) config->MIN_PATIENCE_DECAY = value;
-            else if (strcmp(key, "NUM_OVENS") == 0) config->NUM_OVENS = (int)value;
-            else if (strcmp(key, "MIN_BAKE_TIME") == 0) config->MIN_BAKE_TIME = (int)value;
-            else if (strcmp(key, "MAX_BAKE_TIME") == 0) config->MAX_BAKE_TIME = (int)value;
-            else if (strcmp(key, "CUSTOMER_PROBABILITY") == 0) config->CUSTOMER_PROBABILITY = value;
-            else if (strcmp(key, "MIN_ORDER_ITEMS") == 0) config->MIN_ORDER_ITEMS = (int)value;
-            else if (strcmp(key, "MAX_ORDER_ITEMS") == 0) config->MAX_ORDER_ITEMS = (int)value;
-            else if (strcmp(key, "CUSTOMER_CASCADE_PROBABILITY") == 0) config->CUSTOMER_CASCADE_PROBABILITY = value;
-            else if (strcmp(key, "CASCADE_WINDOW") == 0) config->CASCADE_WINDOW = (int)value;
-            else if (strcmp(key, "REALLOCATION_CHECK_INTERVAL") == 0) config->REALLOCATION_CHECK_INTERVAL = (int)value;
-            else if (strcmp(key, "PRODUCTION_RATIO_THRESHOLD") == 0) config->PRODUCTION_RATIO_THRESHOLD = value;
-            else if (strcmp(key, "MIN_CHEFS_PER_TEAM") == 0) config->MIN_CHEFS_PER_TEAM = (int)value;
-            else if (strcmp(key, "MIN_SELLER_PROCESSING_TIME") == 0) config->MIN_SELLER_PROCESSING_TIME = (int)value;
-            else if (strcmp(key, "MAX_SELLER_PROCESSING_TIME") == 0) config->MAX_SELLER_PROCESSING_TIME = (int)value;
-            else if (strcmp(key, "INGREDIENTS_TO_ORDER") == 0) config->INGREDIENTS_TO_ORDER = (int)value;
+        double value;  // Double so every 32-bit SEED is exact
+        if (sscanf(line, "%40[^=]=%lf", key, &value) == 2) {
 
-            else {
+            if (set_config_value(config, key, value) == -1) {
                 fprintf(stderr, "Unknown key: %s\n", key);
                 fclose(file);
                 return -1;
@@ -164,6 +176,9 @@ void print_config(Config *config) {
     printf("REALLOCATION_CHECK_INTERVAL: %d\n", config->REALLOCATION_CHECK_INTERVAL);
     printf("PRODUCTION_RATIO_THRESHOLD: %f\n", config->PRODUCTION_RATIO_THRESHOLD);
     printf("MIN_CHEFS_PER_TEAM: %d\n", config->MIN_CHEFS_PER_TEAM);
+    printf("TIME_SCALE: %f\n", config->TIME_SCALE);
+    printf("SELLER_WINDOW: %d\n", config->SELLER_WINDOW);
+    printf("PRODUCT_WAIT: %f\n", config->PRODUCT_WAIT);
 
     fflush(stdout);
 }
@@ -191,6 +206,21 @@ int check_parameter_correctness(const Config *config) {
         return -1;
     }
 
+    if (config->TIME_SCALE <= 0) {
+        fprintf(stderr, "TIME_SCALE must be greater than 0\n");
+        return -1;
+    }
+
+    if (config->SELLER_WINDOW < 1) {
+        fprintf(stderr, "SELLER_WINDOW must be at least 1\n");
+        return -1;
+    }
+
+    if (config->PRODUCT_WAIT < 0) {
+        fprintf(stderr, "PRODUCT_WAIT must be greater than or equal to 0\n");
+        return -1;
+    }
+
     // Logical consistency checks for minimum and maximum pairs
     if (config->MIN_PURCHASE_QUANTITY > config->MAX_PURCHASE_QUANTITY) {
         fprintf(stderr, "MIN_PURCHASE_QUANTITY cannot be greater than MAX_PURCHASE_QUANTITY\n");
@@ -236,7 +266,7 @@ int check_parameter_correctness(const Config *config) {
 }
 
 void serialize_config(Config *config, char *buffer) {
-    sprintf(buffer, "%d %d %f %f %f %f %d %d %d %f %d %d %d %d %d %d %d %d %d %d %d %d %d %f %d %d %f %d %d %d %d %d %f %d",
+    sprintf(buffer, "%d %d %f %f %f %f %d %d %d %f %d %d %d %d %d %d %d %d %d %d %d %d %d %f %d %d %f %d %d %d %d %d %f %d %f",
             config->MAX_TIME,
             config->MAX_CUSTOMERS,
             config->MAX_PATIENCE,
@@ -270,11 +300,12 @@ void serialize_config(Config *config, char *buffer) {
             config->INGREDIENTS_TO_ORDER,
             config->REALLOCATION_CHECK_INTERVAL,
             config->PRODUCTION_RATIO_THRESHOLD,
-            config->MIN_CHEFS_PER_TEAM);
+            config->MIN_CHEFS_PER_TEAM,
+            config->TIME_SCALE);
 }
 
 void deserialize_config(const char *buffer, Config *config) {
-    sscanf(buffer, "%d %d %f %f %f %f %d %d %d %f %d %d %d %d %d %d %d %d %d %d %d %d %d %f %d %d %f %d %d %d %d %d %f %d",
+    sscanf(buffer, "%d %d %f %f %f %f %d %d %d %f %d %d %d %d %d %d %d %d %d %d %d %d %d %f %d %d %f %d %d %d %d %d %f %d %f",
             &config->MAX_TIME,
             &config->MAX_CUSTOMERS,
             &config->MAX_PATIENCE,
@@ -308,5 +339,6 @@ void deserialize_config(const char *buffer, Config *config) {
             &config->INGREDIENTS_TO_ORDER,
             &config->REALLOCATION_CHECK_INTERVAL,
             &config->PRODUCTION_RATIO_THRESHOLD,
-            &config->MIN_CHEFS_PER_TEAM);
+            &config->MIN_CHEFS_PER_TEAM,
+            &config->TIME_SCALE);
 }
\ No newline at end of file
@@ -0,0 +1,169 @@
+//
+// ucontext coroutine scheduler, see coroutine.h.
+//
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/msg.h>
+#include "coroutine.h"
+#include "futex_utils.h"
+
+// Scheduler running on this thread, NULL outside coro_scheduler_run
+static __thread CoroScheduler *running_scheduler = NULL;
+
+int coro_active(void) {
+    return running_scheduler != NULL && running_scheduler->current != -1;
+}
+
+// Park the running coroutine until the simulated time wake_at
+static void park_until(double wake_at) {
+    CoroScheduler *scheduler = running_scheduler;
+    Coroutine *coroutine = &scheduler->coroutines[scheduler->current];
+
+    event_queue_push(&scheduler->runnable, wake_at, 0, scheduler->current, 0);
+    swapcontext(&coroutine->context, &scheduler->context);
+}
+
+// sim_sleep inside a coroutine: park instead of blocking the thread
+static double coro_sleep_hook(const SimClock *clock, double seconds) {
+    park_until(sim_now(clock) + (seconds > 0 ? seconds : 0));
+    return 0;
+}
+
+static void trampoline(void) {
+    CoroScheduler *scheduler = running_scheduler;
+    Coroutine *coroutine = &scheduler->coroutines[scheduler->current];
+
+    coroutine->fn(coroutine->arg);
+    coroutine->done = 1;
+    // Returning resumes uc_link, the scheduler loop
+}
+
+int coro_scheduler_init(CoroScheduler *scheduler, const SimClock *clock, int capacity) {
+    scheduler->clock = clock;
+    scheduler->count = 0;
+    scheduler->live = 0;
+    scheduler->current = -1;
+    scheduler->capacity = capacity;
+
+    // Fixed size: a suspended ucontext_t must not move
+    scheduler->coroutines = calloc(capacity, sizeof(Coroutine));
+    if (scheduler->coroutines == NULL) {
+        perror("Failed to allocate coroutines");
+        return -1;
+    }
+    if (event_queue_init(&scheduler->runnable, capacity) == -1) {
+        free(scheduler->coroutines);
+        return -1;
+    }
+    return 0;
+}
+
+void coro_scheduler_destroy(CoroScheduler *scheduler) {
+    for (int i = 0; i < scheduler->count; i++) {
+        free(scheduler->coroutines[i].stack);
+    }
+    free(scheduler->coroutines);
+    event_queue_destroy(&scheduler->runnable);
+}
+
+int coro_spawn(CoroScheduler *scheduler, coro_fn fn, void *arg) {
+    if (scheduler->count == scheduler->capacity) {
+        fprintf(stderr, "Coroutine scheduler full (%d)\n", scheduler->capacity);
+        return -1;
+    }
+
+    int id = scheduler->count;
+    Coroutine *coroutine = &scheduler->coroutines[id];
+
+    coroutine->stack = malloc(CORO_STACK_SIZE);
+    if (coroutine->stack == NULL) {
+        perror("Failed to allocate coroutine stack");
+        return -1;
+    }
+    if (getcontext(&coroutine->context) == -1) {
+        perror("getcontext");
+        free(coroutine->stack);
+        return -1;
+    }
+
+    coroutine->fn = fn;
+    coroutine->arg = arg;
+    coroutine->done = 0;
+    coroutine->context.uc_stack.ss_sp = coroutine->stack;
+    coroutine->context.uc_stack.ss_size = CORO_STACK_SIZE;
+    coroutine->context.uc_link = &scheduler->context;
+    makecontext(&coroutine->context, trampoline, 0);
+
+    scheduler->count++;
+    scheduler->live++;
+    event_queue_push(&scheduler->runnable, 0, 0, id, 0);
+    return id;
+}
+
+void coro_scheduler_run(CoroScheduler *scheduler) {
+    running_scheduler = scheduler;
+
+    while (scheduler->live > 0) {
+        SimEvent next;
+        if (event_queue_peek(&scheduler->runnable, &next) == -1) {
+            break;
+        }
+
+        // Nothing runnable yet: the thread itself sleeps until the next wake-up
+        double now = sim_now(scheduler->clock);
+        if (next.time > now) {
+            sim_sleep(scheduler->clock, next.time - now);
+            continue;
+        }
+
+        event_queue_pop(&scheduler->runnable, &next);
+        Coroutine *coroutine = &scheduler->coroutines[next.actor];
+
+        scheduler->current = next.actor;
+        sim_clock_set_sleep_hook(coro_sleep_hook);
+        swapcontext(&scheduler->context, &coroutine->context);
+        sim_clock_set_sleep_hook(NULL);
+        scheduler->current = -1;
+
+        if (coroutine->done) {
+            free(coroutine->stack);
+            coroutine->stack = NULL;
+            scheduler->live--;
+        }
+    }
+
+    running_scheduler = NULL;
+}
+
+void coro_yield(void) {
+    if (coro_active()) {
+        park_until(sim_now(running_scheduler->clock));
+    }
+}
+
+ssize_t coro_msgrcv(int msqid, void *msgp, size_t msgsz, long msgtyp, int msgflg) {
+    if (!coro_active()) {
+        return msgrcv(msqid, msgp, msgsz, msgtyp, msgflg);
+    }
+
+    for (;;) {
+        ssize_t received = msgrcv(msqid, msgp, msgsz, msgtyp, msgflg | IPC_NOWAIT);
+        if (received >= 0 || errno != ENOMSG || (msgflg & IPC_NOWAIT)) {
+            return received;
+        }
+        park_until(sim_now(running_scheduler->clock) + CORO_POLL_INTERVAL);
+    }
+}
+
+int coro_futex_wait(uint32_t *addr, uint32_t expected) {
+    if (!coro_active()) {
+        return futex_wait(addr, expected);
+    }
+
+    while (__atomic_load_n(addr, __ATOMIC_ACQUIRE) == expected) {
+        park_until(sim_now(running_scheduler->clock) + CORO_POLL_INTERVAL);
+    }
+    return 0;
+}
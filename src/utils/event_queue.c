@@ -0,0 +1,128 @@
+//
+// Binary-heap event calendar used by the headless simulation.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "event_queue.h"
+
+// Returns 1 if event a must fire before event b
+static int event_before(const SimEvent *a, const SimEvent *b) {
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+    return a->seq < b->seq;
+}
+
+static void swap_events(SimEvent *a, SimEvent *b) {
+    SimEvent tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+int event_queue_init(EventQueue *queue, size_t initial_capacity) {
+    if (initial_capacity == 0) {
+        initial_capacity = 64;
+    }
+
+    queue->events = malloc(initial_capacity * sizeof(SimEvent));
+    if (!queue->events) {
+        perror("Failed to allocate event queue");
+        return -1;
+    }
+
+    queue->count = 0;
+    queue->capacity = initial_capacity;
+    queue->next_seq = 0;
+    return 0;
+}
+
+void event_queue_destroy(EventQueue *queue) {
+    free(queue->events);
+    queue->events = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+}
+
+int event_queue_push(EventQueue *queue, double time, int type, int actor, int data) {
+    // Grow the heap when it is full
+    if (queue->count == queue->capacity) {
+        size_t new_capacity = queue->capacity * 2;
+        SimEvent *events = realloc(queue->events, new_capacity * sizeof(SimEvent));
+        if (!events) {
+            perror("Failed to grow event queue");
+            return -1;
+        }
+        queue->events = events;
+        queue->capacity = new_capacity;
+    }
+
+    size_t i = queue->count++;
+    queue->events[i].time = time;
+    queue->events[i].seq = queue->next_seq++;
+    queue->events[i].type = type;
+    queue->events[i].actor = actor;
+    queue->events[i].data = data;
+
+    // Sift up
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!event_before(&queue->events[i], &queue->events[parent])) {
+            break;
+        }
+        swap_events(&queue->events[i], &queue->events[parent]);
+        i = parent;
+    }
+
+    return 0;
+}
+
+int event_queue_pop(EventQueue *queue, SimEvent *event) {
+    if (queue->count == 0) {
+        return -1;
+    }
+
+    if (event) {
+        *event = queue->events[0];
+    }
+
+    queue->events[0] = queue->events[--queue->count];
+
+    // Sift down
+    size_t i = 0;
+    while (1) {
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        size_t smallest = i;
+
+        if (left < queue->count && event_before(&queue->events[left], &queue->events[smallest])) {
+            smallest = left;
+        }
+        if (right < queue->count && event_before(&queue->events[right], &queue->events[smallest])) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            break;
+        }
+        swap_events(&queue->events[i], &queue->events[smallest]);
+        i = smallest;
+    }
+
+    return 0;
+}
+
+int event_queue_peek(const EventQueue *queue, SimEvent *event) {
+    if (queue->count == 0) {
+        return -1;
+    }
+    *event = queue->events[0];
+    return 0;
+}
+
+int event_queue_is_empty(const EventQueue *queue) {
+    return queue->count == 0;
+}
+
+size_t event_queue_size(const EventQueue *queue) {
+    return queue->count;
+}
@@ -0,0 +1,42 @@
+//
+// Process-shared futex wait/wake (no FUTEX_PRIVATE_FLAG, the words are in shm).
+//
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "futex_utils.h"
+
+int futex_wait(uint32_t *addr, uint32_t expected) {
+    long result = syscall(SYS_futex, addr, FUTEX_WAIT, expected, NULL, NULL, 0);
+    if (result == -1 && errno != EAGAIN && errno != EINTR) {
+        perror("futex wait failed");
+        return -1;
+    }
+    return 0;
+}
+
+int futex_wait_timeout(uint32_t *addr, uint32_t expected, const struct timespec *timeout) {
+    long result = syscall(SYS_futex, addr, FUTEX_WAIT, expected, timeout, NULL, 0);
+    if (result == -1) {
+        if (errno == ETIMEDOUT) {
+            return 1;
+        }
+        if (errno != EAGAIN && errno != EINTR) {
+            perror("futex wait failed");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int futex_wake(uint32_t *addr, int count) {
+    long result = syscall(SYS_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
+    if (result == -1) {
+        perror("futex wake failed");
+        return -1;
+    }
+    return (int) result;
+}
@@ -0,0 +1,55 @@
+//
+// Sharded KPI counters, see game_stats.h.
+//
+
+#include <pthread.h>
+#include <string.h>
+#include "game_stats.h"
+
+_Static_assert(sizeof(StatShard) == CACHE_LINE, "a shard must fill exactly one cache line");
+
+// Shard of the calling thread, -1 until its first write
+static __thread int my_shard = -1;
+static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+
+// A forked child is a new writer and claims its own shard
+static void forget_shard(void) {
+    my_shard = -1;
+}
+
+static void register_atfork(void) {
+    pthread_atfork(NULL, NULL, forget_shard);
+}
+
+void stats_reset(GameStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+static StatShard *writer_shard(GameStats *stats) {
+    if (my_shard == -1) {
+        pthread_once(&atfork_once, register_atfork);
+        my_shard = __atomic_fetch_add(&stats->next_shard, 1, __ATOMIC_RELAXED) % MAX_STAT_SHARDS;
+    }
+    return &stats->shards[my_shard];
+}
+
+void stats_add(GameStats *stats, StatCounter counter, int64_t amount) {
+    // Atomic even though the shard is ours: shards are shared past MAX_STAT_SHARDS
+    __atomic_add_fetch(&writer_shard(stats)->values[counter], amount, __ATOMIC_RELAXED);
+}
+
+void stats_add_profit(GameStats *stats, float amount) {
+    stats_add(stats, STAT_PROFIT, (int64_t) (amount * STATS_PROFIT_SCALE + (amount < 0 ? -0.5f : 0.5f)));
+}
+
+int64_t stats_read(const GameStats *stats, StatCounter counter) {
+    int64_t total = 0;
+    for (int i = 0; i < MAX_STAT_SHARDS; i++) {
+        total += __atomic_load_n(&stats->shards[i].values[counter], __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+float stats_profit(const GameStats *stats) {
+    return (float) stats_read(stats, STAT_PROFIT) / STATS_PROFIT_SCALE;
+}
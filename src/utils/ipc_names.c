@@ -0,0 +1,71 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "ipc_names.h"
+
+// Keys live in 0x40000000 + (instance << 4 | key), well away from the
+// small literal keys other programs tend to use
+#define IPC_KEY_BASE 0x40000000
+#define IPC_INSTANCE_BITS 22
+
+static const char *base_names[IPC_NAME_COUNT] = {
+    [IPC_GAME_SHM] = "/game_shared_mem",
+    [IPC_CUSTOMER_QUEUE_SHM] = "/customer_queue_shm",
+    [IPC_BAKE_CHANNEL_SHM] = "/bake_channel_shm",
+    [IPC_ARENA_SHM] = "/bakery_arena_shm",
+    [IPC_COMPLAINT_SEM] = "/bakery_complaint_sem",
+    [IPC_OVEN_SEM] = "/oven_sem",
+};
+
+static pthread_once_t resolve_once = PTHREAD_ONCE_INIT;
+static unsigned int instance = 0;
+static char names[IPC_NAME_COUNT][64];
+
+static void build_names(void) {
+    for (int i = 0; i < IPC_NAME_COUNT; i++) {
+        snprintf(names[i], sizeof(names[i]), "%s_%u", base_names[i], instance);
+    }
+}
+
+// Children: take the instance the launcher exported
+static void resolve_instance(void) {
+    const char *value = getenv(INSTANCE_ENV);
+    instance = value != NULL ? (unsigned int) strtoul(value, NULL, 10) : 0;
+    build_names();
+}
+
+void ipc_set_instance(unsigned int id) {
+    char value[16];
+
+    pthread_once(&resolve_once, resolve_instance);
+    instance = id;
+    build_names();
+
+    snprintf(value, sizeof(value), "%u", id);
+    if (setenv(INSTANCE_ENV, value, 1) == -1) {
+        perror("setenv " INSTANCE_ENV);
+    }
+}
+
+void ipc_init_instance(void) {
+    const char *value = getenv(INSTANCE_ENV);
+    ipc_set_instance(value != NULL ? (unsigned int) strtoul(value, NULL, 10) : (unsigned int) getpid());
+    printf("Run instance: %u\n", instance);
+}
+
+unsigned int ipc_instance(void) {
+    pthread_once(&resolve_once, resolve_instance);
+    return instance;
+}
+
+const char *ipc_name(IpcName name) {
+    pthread_once(&resolve_once, resolve_instance);
+    return names[name];
+}
+
+key_t ipc_key(IpcKey key) {
+    pthread_once(&resolve_once, resolve_instance);
+    unsigned int masked = instance & ((1u << IPC_INSTANCE_BITS) - 1);
+    return (key_t) (IPC_KEY_BASE | (masked << 4) | key);
+}
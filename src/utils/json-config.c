@@ -4,8 +4,9 @@
 
 #include <json-c/json.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include "products.h"
+#include "config.h"
 
 
 int load_product_catalog(const char *filename, ProductCatalog *catalog) {
@@ -56,13 +57,14 @@ int load_product_catalog(const char *filename, ProductCatalog *catalog) {
         // Process products in this category
         current_category->product_count = 0;
         int array_len = json_object_array_length(category_array);
+        current_category->products = calloc(array_len > 0 ? array_len : 1, sizeof(Product));
+        if (current_category->products == NULL) {
+            perror("Failed to allocate products");
+            json_object_put(parsed_json);
+            free_product_catalog(catalog);
+            return -1;
+        }
         for (int i = 0; i < array_len; i++) {
-            if (current_category->product_count >= MAX_PRODUCTS_PER_CATEGORY) {
-                fprintf(stderr, "Warning: Maximum products per category reached for %s\n",
-                        category_name);
-                break;
-            }
-
             product_obj = json_object_array_get_idx(category_array, i);
             Product *current_product = &current_category->products[current_category->product_count];
 
@@ -128,4 +130,13 @@ int load_product_catalog(const char *filename, ProductCatalog *catalog) {
     json_object_put(parsed_json);
 
     return 0;
+}
+
+void free_product_catalog(ProductCatalog *catalog) {
+    for (int i = 0; i < NUM_PRODUCTS; i++) {
+        free(catalog->categories[i].products);
+        catalog->categories[i].products = NULL;
+        catalog->categories[i].product_count = 0;
+    }
+    catalog->category_count = 0;
 }
\ No newline at end of file
@@ -6,14 +6,14 @@
 #include <sys/ipc.h>
 #include <sys/msg.h>
 
-// Create a message queue or get existing one
-int get_message_queue() {
-    int msgid = msgget(CUSTOMER_SELLER_MSG_KEY, 0666 | IPC_CREAT);
+// Queue the sellers use to reach the customers living in the customer manager
+int get_customer_inbox_queue() {
+    int msgid = msgget(CUSTOMER_INBOX_MSG_KEY, 0666 | IPC_CREAT);
 
     if (msgid == -1) {
-        perror("Failed to create/access message queue");
+        perror("Failed to create/access customer inbox queue");
         return -1;
     }
 
     return msgid;
-}
\ No newline at end of file
+}
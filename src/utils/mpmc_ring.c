@@ -0,0 +1,159 @@
+//
+// Bounded MPMC ring with per-cell sequence numbers, see mpmc_ring.h.
+//
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "futex_utils.h"
+#include "mpmc_ring.h"
+
+#define CELL_HEADER 8   // Sequence word, padded so elements stay 8-byte aligned
+
+static uint32_t *cell_sequence(const MpmcRing *ring, uint32_t pos) {
+    return (uint32_t *) (ring->cells + (size_t) (pos & ring->mask) * ring->cell_size);
+}
+
+static void *cell_data(const MpmcRing *ring, uint32_t pos) {
+    return (unsigned char *) cell_sequence(ring, pos) + CELL_HEADER;
+}
+
+static uint32_t cell_size(uint32_t elem_size) {
+    return CELL_HEADER + ((elem_size + 7) & ~7u);
+}
+
+uint32_t mpmc_ring_capacity(uint32_t count) {
+    uint32_t capacity = 1;
+    while (capacity < count) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+size_t mpmc_ring_size(uint32_t elem_size, uint32_t capacity) {
+    return sizeof(MpmcRing) + (size_t) capacity * cell_size(elem_size);
+}
+
+int mpmc_ring_init(MpmcRing *ring, uint32_t elem_size, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        fprintf(stderr, "Ring capacity %u is not a power of two\n", capacity);
+        return -1;
+    }
+
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    ring->elem_size = elem_size;
+    ring->cell_size = cell_size(elem_size);
+    ring->enqueue_pos = 0;
+    ring->dequeue_pos = 0;
+    ring->items = 0;
+    ring->waiters = 0;
+    ring->slots = 0;
+    ring->slot_waiters = 0;
+
+    // Cell i is free for the producer that claims position i
+    for (uint32_t i = 0; i < capacity; i++) {
+        *cell_sequence(ring, i) = i;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    return 0;
+}
+
+int mpmc_ring_push(MpmcRing *ring, const void *elem) {
+    uint32_t pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+
+    for (;;) {
+        uint32_t *sequence = cell_sequence(ring, pos);
+        int32_t diff = (int32_t) (__atomic_load_n(sequence, __ATOMIC_ACQUIRE) - pos);
+
+        if (diff == 0) {
+            // Free cell: claim the position, a failed CAS reloads pos
+            if (__atomic_compare_exchange_n(&ring->enqueue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                memcpy(cell_data(ring, pos), elem, ring->elem_size);
+                __atomic_store_n(sequence, pos + 1, __ATOMIC_RELEASE);
+                break;
+            }
+        } else if (diff < 0) {
+            return -1;  // The consumer of the previous lap has not freed the cell: full
+        } else {
+            pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Pairs with the waiters increment in mpmc_ring_pop_wait: either the
+    // consumer sees the new items value, or we see it waiting and wake it
+    __atomic_add_fetch(&ring->items, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&ring->items, 1);
+    }
+    return 0;
+}
+
+int mpmc_ring_pop(MpmcRing *ring, void *elem) {
+    uint32_t pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+
+    for (;;) {
+        uint32_t *sequence = cell_sequence(ring, pos);
+        int32_t diff = (int32_t) (__atomic_load_n(sequence, __ATOMIC_ACQUIRE) - (pos + 1));
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->dequeue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                memcpy(elem, cell_data(ring, pos), ring->elem_size);
+                // Free the cell for the producer one lap ahead
+                __atomic_store_n(sequence, pos + ring->mask + 1, __ATOMIC_RELEASE);
+                break;
+            }
+        } else if (diff < 0) {
+            return -1;  // Nothing published at this position yet: empty
+        } else {
+            pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    __atomic_add_fetch(&ring->slots, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->slot_waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&ring->slots, 1);
+    }
+    return 0;
+}
+
+static double timespec_seconds(const struct timespec *ts) {
+    return (double) ts->tv_sec + (double) ts->tv_nsec / 1e9;
+}
+
+int mpmc_ring_pop_wait(MpmcRing *ring, void *elem, const struct timespec *timeout) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double deadline = timespec_seconds(&now) + timespec_seconds(timeout);
+
+    for (;;) {
+        uint32_t seen = __atomic_load_n(&ring->items, __ATOMIC_SEQ_CST);
+        if (mpmc_ring_pop(ring, elem) == 0) {
+            return 0;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double left = deadline - timespec_seconds(&now);
+        if (left <= 0) {
+            return -1;
+        }
+        struct timespec wait = {.tv_sec = (time_t) left};
+        wait.tv_nsec = (long) ((left - (double) wait.tv_sec) * 1e9);
+
+        // Sleeps only if nothing was pushed since seen was read
+        __atomic_add_fetch(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+        int result = futex_wait_timeout(&ring->items, seen, &wait);
+        __atomic_sub_fetch(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+        if (result == -1) {
+            return -1;
+        }
+    }
+}
+
+uint32_t mpmc_ring_count(const MpmcRing *ring) {
+    uint32_t head = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_ACQUIRE);
+    return tail - head;
+}
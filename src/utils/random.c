@@ -1,13 +1,102 @@
 #include "random.h"
-#include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
 
-void init_random() {
-    srand(time(NULL) ^ getpid());
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
 }
 
-float random_float(float min, float max) {
-    float scale = rand() / (float)RAND_MAX;
-    return min + scale * (max - min);
+// splitmix64, used only to expand a seed into xoshiro state
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+unsigned int resolve_seed(unsigned int seed) {
+    if (seed != 0) {
+        return seed;
+    }
+    seed = (unsigned int) (time(NULL) ^ getpid());
+    return seed != 0 ? seed : 1;
+}
+
+void random_stream_init(RandomStream *stream, uint64_t seed, RandomRole role, int id) {
+    // Distinct (role, id) pairs start splitmix at distinct points
+    uint64_t key = ((uint64_t) role << 32) | (uint32_t) id;
+    uint64_t state = seed ^ splitmix64(&key);
+
+    for (int i = 0; i < 4; i++) {
+        stream->s[i] = splitmix64(&state);
+    }
+}
+
+uint64_t random_next(RandomStream *stream) {
+    uint64_t *s = stream->s;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+// Lemire's multiply-shift with rejection, no modulo bias
+static inline uint32_t bounded(RandomStream *stream, uint32_t bound) {
+    uint64_t product = (random_next(stream) >> 32) * bound;
+    uint32_t low = (uint32_t) product;
+
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            product = (random_next(stream) >> 32) * bound;
+            low = (uint32_t) product;
+        }
+    }
+    return (uint32_t) (product >> 32);
+}
+
+// Top 24 bits give every float in [0, 1) a step of 2^-24
+static inline float unit_float(RandomStream *stream) {
+    return (float) (random_next(stream) >> 40) * (1.0f / 16777216.0f);
+}
+
+uint32_t random_below(RandomStream *stream, uint32_t bound) {
+    return bound > 1 ? bounded(stream, bound) : 0;
+}
+
+int random_int(RandomStream *stream, int min, int max) {
+    if (max <= min) {
+        return min;
+    }
+    return min + (int) bounded(stream, (uint32_t) (max - min + 1));
+}
+
+float random_float(RandomStream *stream, float min, float max) {
+    return min + unit_float(stream) * (max - min);
+}
+
+void random_fill_below(RandomStream *stream, uint32_t *out, int n, uint32_t bound) {
+    if (bound <= 1) {
+        for (int i = 0; i < n; i++) {
+            out[i] = 0;
+        }
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        out[i] = bounded(stream, bound);
+    }
+}
+
+void random_fill_float(RandomStream *stream, float *out, int n, float min, float max) {
+    float range = max - min;
+    for (int i = 0; i < n; i++) {
+        out[i] = min + unit_float(stream) * range;
+    }
 }
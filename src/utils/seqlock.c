@@ -0,0 +1,88 @@
+//
+// Sequence locks, see seqlock.h.
+//
+
+#include <sched.h>
+#include <string.h>
+#include "seqlock.h"
+
+#define SEQLOCK_SPINS 100            // Spins on an odd sequence before yielding the CPU
+#define SEQLOCK_STALL_YIELDS 1000    // Yields on one odd sequence before a bounded read gives up
+
+void seqlock_init(SeqLock *lock) {
+    __atomic_store_n(&lock->sequence, 0, __ATOMIC_RELAXED);
+}
+
+void seqlock_write_begin(SeqLock *lock) {
+    uint32_t sequence = lock->sequence;
+    // Writers are serialised, so an odd sequence here is a dead writer's:
+    // skip past it rather than turn it even while we write
+    if (sequence & 1) {
+        sequence++;
+    }
+    __atomic_store_n(&lock->sequence, sequence + 1, __ATOMIC_RELAXED);
+    // The odd sequence must be visible before any of the data stores
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void seqlock_write_end(SeqLock *lock) {
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELEASE);
+}
+
+uint32_t seqlock_read_begin(const SeqLock *lock) {
+    int spins = 0;
+    uint32_t sequence;
+
+    while ((sequence = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE)) & 1) {
+        // The writer may be a preempted process; do not burn its time slice
+        if (++spins == SEQLOCK_SPINS) {
+            sched_yield();
+            spins = 0;
+        }
+    }
+    return sequence;
+}
+
+int seqlock_read_retry(const SeqLock *lock, uint32_t start) {
+    // The data loads must complete before the sequence is checked again
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) != start;
+}
+
+void seqlock_read_copy(const SeqLock *lock, void *dst, const void *src, size_t size) {
+    uint32_t start;
+    do {
+        start = seqlock_read_begin(lock);
+        memcpy(dst, src, size);
+    } while (seqlock_read_retry(lock, start));
+}
+
+int seqlock_read_copy_bounded(const SeqLock *lock, void *dst, const void *src, size_t size) {
+    uint32_t stuck_on = 0;
+    int spins = 0, yields = 0;
+
+    for (;;) {
+        uint32_t start = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE);
+        if (start & 1) {
+            // Only time spent on the same odd value counts: a live writer moves on
+            if (start != stuck_on) {
+                stuck_on = start;
+                yields = 0;
+            }
+            if (++spins == SEQLOCK_SPINS) {
+                spins = 0;
+                if (++yields == SEQLOCK_STALL_YIELDS) {
+                    memcpy(dst, src, size);
+                    return -1;
+                }
+                sched_yield();
+            }
+            continue;
+        }
+
+        memcpy(dst, src, size);
+        if (!seqlock_read_retry(lock, start)) {
+            return 0;
+        }
+    }
+}
@@ -1,69 +1,97 @@
 #include "shared_mem_utils.h"
 #include <fcntl.h>
 #include <sys/mman.h>
-#include "customer.h"
-#include "queue.h"
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 
+int create_shared_memory(const Config *config, const ProductCatalog *catalog, Game **shared_game) {
+    size_t size = game_size(config, catalog);
 
-int setup_shared_memory(Game **shared_game) {
-    // Setup game shared memory as before
     int shm_fd = shm_open(GAME_SHM_NAME, O_CREAT | O_RDWR, 0666);
-    ftruncate(shm_fd, sizeof(Game));
-    *shared_game = mmap(0, sizeof(Game), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-
-    if (*shared_game == MAP_FAILED) {
-        perror("Failed to map shared memory");
+    if (shm_fd == -1) {
+        perror("Failed to open shared memory");
         exit(EXIT_FAILURE);
     }
+    if (ftruncate(shm_fd, (off_t) size) == -1) {
+        perror("Failed to size shared memory");
+        exit(EXIT_FAILURE);
+    }
+    *shared_game = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
 
-    fcntl(shm_fd, F_SETFD, fcntl(shm_fd, F_GETFD) & ~FD_CLOEXEC);
     if (*shared_game == MAP_FAILED) {
         perror("Failed to map shared memory");
         exit(EXIT_FAILURE);
     }
+    memset(*shared_game, 0, size);
+    game_layout(*shared_game, config, catalog);
+
+    // Children get the fd on their command line
+    fcntl(shm_fd, F_SETFD, fcntl(shm_fd, F_GETFD) & ~FD_CLOEXEC);
+    printf("Game segment: %zu bytes for %d chefs, %d bakers, %d sellers, %d ovens, %d products\n", size,
+           (*shared_game)->layout.chef_slots, (*shared_game)->layout.baker_slots,
+           (*shared_game)->layout.seller_slots, (*shared_game)->layout.oven_slots,
+           (*shared_game)->layout.product_slots);
 
     return shm_fd;
 }
 
-void cleanup_shared_memory(Game *shared_game) {
-    if (shared_game != NULL && shared_game != MAP_FAILED) {
-        if (munmap(shared_game, sizeof(Game)) == -1) {
-            perror("munmap failed");
-        }
+Game *map_shared_game(int shm_fd) {
+    // The launcher sized the segment from its config; the header says how
+    struct stat st;
+    if (fstat(shm_fd, &st) == -1 || (size_t) st.st_size < sizeof(Game)) {
+        fprintf(stderr, "Game shared memory is not set up\n");
+        return NULL;
     }
-    shm_unlink(GAME_SHM_NAME);
-}
 
-void cleanup_queue_shared_memory(queue_shm *queue_shm, size_t capacity) {
-    size_t elemSize = sizeof(Customer);
-    size_t shm_size = queueShmSize(elemSize, capacity);
-
-    if (queue_shm != NULL && queue_shm != MAP_FAILED) {
-        if (munmap(queue_shm, shm_size) == -1) {
-            perror("munmap failed");
-        }
+    Game *game = mmap(0, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (game == MAP_FAILED) {
+        perror("Failed to map shared memory");
+        return NULL;
+    }
+    // A foreign segment, another layout version and a resized one are told apart
+    if (game->layout.magic != GAME_LAYOUT_MAGIC) {
+        fprintf(stderr, "Game shared memory has magic 0x%08x, expected 0x%08x\n",
+                game->layout.magic, GAME_LAYOUT_MAGIC);
+    } else if (game->layout.version != GAME_LAYOUT_VERSION) {
+        fprintf(stderr, "Game shared memory has layout version %u, expected %u\n",
+                game->layout.version, GAME_LAYOUT_VERSION);
+    } else if (game->layout.size != (size_t) st.st_size) {
+        fprintf(stderr, "Game shared memory is %zu bytes, its header says %zu\n",
+                (size_t) st.st_size, game->layout.size);
+    } else {
+        return game;
     }
-    shm_unlink(CUSTOMER_QUEUE_SHM_NAME);
+    munmap(game, (size_t) st.st_size);
+    return NULL;
 }
 
-void setup_queue_shared_memory(queue_shm **queue_shm, size_t capacity) {
-    size_t elemSize = sizeof(Customer);
-    size_t shm_size = queueShmSize(elemSize, capacity);
-
-    int queue_fd = shm_open(CUSTOMER_QUEUE_SHM_NAME, O_CREAT | O_RDWR, 0666);
-    if (queue_fd == -1) {
-        perror("Failed to open queue shared memory");
+int setup_shared_memory(Game **shared_game) {
+    int shm_fd = shm_open(GAME_SHM_NAME, O_RDWR, 0666);
+    if (shm_fd == -1) {
+        perror("Failed to open shared memory");
         exit(EXIT_FAILURE);
     }
-    ftruncate(queue_fd, (long) shm_size);
-    *queue_shm = mmap(NULL, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, queue_fd, 0);
 
-    if (*queue_shm == MAP_FAILED) {
-        perror("Failed to map queue shared memory");
+    *shared_game = map_shared_game(shm_fd);
+    if (*shared_game == NULL) {
         exit(EXIT_FAILURE);
     }
 
-    fcntl(queue_fd, F_SETFD, fcntl(queue_fd, F_GETFD) & ~FD_CLOEXEC);
-    close(queue_fd);
-}
\ No newline at end of file
+    return shm_fd;
+}
+
+void unmap_shared_game(Game *shared_game) {
+    if (shared_game != NULL && shared_game != MAP_FAILED) {
+        if (munmap(shared_game, shared_game->layout.size) == -1) {
+            perror("munmap failed");
+        }
+    }
+}
+
+void cleanup_shared_memory(Game *shared_game) {
+    unmap_shared_game(shared_game);
+    shm_unlink(GAME_SHM_NAME);
+}
@@ -0,0 +1,282 @@
+//
+// Shared-memory slab allocator, see shm_arena.h.
+//
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shm_arena.h"
+
+#define ARENA_MAGIC 0x41524e41u
+#define BLOCK_HEADER 8      // Keeps payloads 8-byte aligned
+
+typedef struct {
+    uint32_t next;          // Next free block while on a free list
+    uint16_t size_class;
+    uint16_t in_use;
+} BlockHeader;
+
+// Free blocks of one thread, for the one arena mapping it uses
+typedef struct {
+    const ShmArena *arena;
+    uint32_t count[SHM_ARENA_CLASSES];
+    ShmRef blocks[SHM_ARENA_CLASSES][SHM_ARENA_CACHE];
+} ArenaCache;
+
+static __thread ArenaCache cache;
+static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+
+static size_t align_line(size_t size) {
+    return (size + CACHE_LINE - 1) & ~((size_t) CACHE_LINE - 1);
+}
+
+static uint32_t class_block(int size_class) {
+    return (uint32_t) SHM_ARENA_MIN_BLOCK << size_class;
+}
+
+static int size_class(size_t size) {
+    for (int c = 0; c < SHM_ARENA_CLASSES; c++) {
+        if (size <= class_block(c) - BLOCK_HEADER) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+static BlockHeader *block_header(ShmArena *arena, ShmRef ref) {
+    return (BlockHeader *) ((unsigned char *) arena + ref - BLOCK_HEADER);
+}
+
+size_t shm_arena_size(size_t payload) {
+    return align_line(sizeof(ShmArena)) + align_line(payload);
+}
+
+size_t shm_arena_block_size(size_t size) {
+    int c = size_class(size);
+    return c < 0 ? 0 : class_block(c);
+}
+
+ShmArena *shm_arena_create(const char *name, size_t size) {
+    if (size > UINT32_MAX || size < shm_arena_size(SHM_ARENA_MIN_BLOCK)) {
+        fprintf(stderr, "Arena size %zu out of range\n", size);
+        return NULL;
+    }
+
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0666);
+    if (fd == -1) {
+        perror("Failed to open arena shared memory");
+        return NULL;
+    }
+    if (ftruncate(fd, (off_t) size) == -1) {
+        perror("Failed to size arena shared memory");
+        close(fd);
+        return NULL;
+    }
+
+    ShmArena *arena = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (arena == MAP_FAILED) {
+        perror("Failed to map arena shared memory");
+        return NULL;
+    }
+
+    // Blocks are zero from ftruncate and only touched once carved
+    memset(arena, 0, sizeof(ShmArena));
+    arena->size = (uint32_t) size;
+    arena->data = (uint32_t) align_line(sizeof(ShmArena));
+    arena->top = arena->data;
+    // Publish the magic last: mappers treat anything else as not laid out
+    __atomic_store_n(&arena->magic, ARENA_MAGIC, __ATOMIC_RELEASE);
+    return arena;
+}
+
+ShmArena *shm_arena_map(const char *name) {
+    int fd = shm_open(name, O_RDWR, 0666);
+    if (fd == -1) {
+        perror("Failed to open arena shared memory");
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t) st.st_size < sizeof(ShmArena)) {
+        fprintf(stderr, "Arena shared memory is not set up\n");
+        close(fd);
+        return NULL;
+    }
+
+    ShmArena *arena = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (arena == MAP_FAILED) {
+        perror("Failed to map arena shared memory");
+        return NULL;
+    }
+    if (__atomic_load_n(&arena->magic, __ATOMIC_ACQUIRE) != ARENA_MAGIC ||
+        arena->size != (uint32_t) st.st_size) {
+        fprintf(stderr, "Arena shared memory is not laid out\n");
+        munmap(arena, (size_t) st.st_size);
+        return NULL;
+    }
+    return arena;
+}
+
+void shm_arena_unmap(ShmArena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    shm_arena_flush_cache(arena);
+    if (munmap(arena, arena->size) == -1) {
+        perror("munmap failed");
+    }
+}
+
+/* --- shared free lists ---------------------------------------------- */
+
+static void push_free(ShmArena *arena, int c, ShmRef ref) {
+    uint64_t *head = &arena->free[c].head;
+    uint64_t old = __atomic_load_n(head, __ATOMIC_RELAXED);
+    uint64_t new;
+
+    do {
+        __atomic_store_n(&block_header(arena, ref)->next, (uint32_t) old, __ATOMIC_RELAXED);
+        new = ((old >> 32) + 1) << 32 | ref;
+    } while (!__atomic_compare_exchange_n(head, &old, new, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static ShmRef pop_free(ShmArena *arena, int c) {
+    uint64_t *head = &arena->free[c].head;
+    uint64_t old = __atomic_load_n(head, __ATOMIC_ACQUIRE);
+
+    for (;;) {
+        ShmRef ref = (ShmRef) old;
+        if (ref == SHM_REF_NULL) {
+            return SHM_REF_NULL;
+        }
+        // May read the link of a block another thread just took; the tag
+        // makes the exchange fail then
+        uint32_t next = __atomic_load_n(&block_header(arena, ref)->next, __ATOMIC_RELAXED);
+        uint64_t new = ((old >> 32) + 1) << 32 | next;
+        if (__atomic_compare_exchange_n(head, &old, new, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            return ref;
+        }
+    }
+}
+
+static ShmRef carve(ShmArena *arena, int c) {
+    uint32_t block = class_block(c);
+    uint32_t top = __atomic_load_n(&arena->top, __ATOMIC_RELAXED);
+
+    do {
+        if (top > arena->size || arena->size - top < block) {
+            return SHM_REF_NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&arena->top, &top, top + block, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    ShmRef ref = top + BLOCK_HEADER;
+    block_header(arena, ref)->size_class = (uint16_t) c;
+    return ref;
+}
+
+/* --- per-thread caches ---------------------------------------------- */
+
+// A forked child starts with an empty cache: the blocks it inherited are
+// still the parent's to hand out
+static void forget_cache(void) {
+    memset(&cache, 0, sizeof(cache));
+}
+
+static void register_atfork(void) {
+    pthread_atfork(NULL, NULL, forget_cache);
+}
+
+// NULL when this thread already caches blocks of another mapping
+static ArenaCache *thread_cache(const ShmArena *arena) {
+    if (cache.arena == NULL) {
+        pthread_once(&atfork_once, register_atfork);
+        cache.arena = arena;
+    }
+    return cache.arena == arena ? &cache : NULL;
+}
+
+ShmRef shm_arena_alloc(ShmArena *arena, size_t size) {
+    int c = size_class(size);
+    if (c < 0) {
+        fprintf(stderr, "Arena: no block holds %zu bytes\n", size);
+        return SHM_REF_NULL;
+    }
+
+    ArenaCache *local = thread_cache(arena);
+    ShmRef ref = SHM_REF_NULL;
+    if (local != NULL) {
+        if (local->count[c] == 0) {
+            // Take half a cache at once so the next allocs stay local
+            ShmRef free_ref;
+            while (local->count[c] < SHM_ARENA_CACHE / 2 &&
+                   (free_ref = pop_free(arena, c)) != SHM_REF_NULL) {
+                local->blocks[c][local->count[c]++] = free_ref;
+            }
+        }
+        if (local->count[c] > 0) {
+            ref = local->blocks[c][--local->count[c]];
+        }
+    } else {
+        ref = pop_free(arena, c);
+    }
+    if (ref == SHM_REF_NULL) {
+        ref = carve(arena, c);
+        if (ref == SHM_REF_NULL) {
+            return SHM_REF_NULL;
+        }
+    }
+
+    __atomic_store_n(&block_header(arena, ref)->in_use, 1, __ATOMIC_RELAXED);
+    return ref;
+}
+
+void shm_arena_free(ShmArena *arena, ShmRef ref) {
+    if (ref == SHM_REF_NULL) {
+        return;
+    }
+    BlockHeader *header = block_header(arena, ref);
+    if (__atomic_exchange_n(&header->in_use, 0, __ATOMIC_RELAXED) == 0) {
+        fprintf(stderr, "Arena: block %u freed twice\n", ref);
+        return;
+    }
+
+    int c = header->size_class;
+    ArenaCache *local = thread_cache(arena);
+    if (local == NULL) {
+        push_free(arena, c, ref);
+        return;
+    }
+
+    // A full cache gives half back, so a thread that only frees (a seller
+    // freeing orders) keeps feeding the threads that allocate
+    if (local->count[c] == SHM_ARENA_CACHE) {
+        while (local->count[c] > SHM_ARENA_CACHE / 2) {
+            push_free(arena, c, local->blocks[c][--local->count[c]]);
+        }
+    }
+    local->blocks[c][local->count[c]++] = ref;
+}
+
+void shm_arena_flush_cache(ShmArena *arena) {
+    if (cache.arena != arena) {
+        return;
+    }
+    for (int c = 0; c < SHM_ARENA_CLASSES; c++) {
+        while (cache.count[c] > 0) {
+            push_free(arena, c, cache.blocks[c][--cache.count[c]]);
+        }
+    }
+    cache.arena = NULL;
+}
+
+size_t shm_arena_carved(const ShmArena *arena) {
+    return __atomic_load_n(&arena->top, __ATOMIC_RELAXED) - arena->data;
+}
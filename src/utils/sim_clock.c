@@ -0,0 +1,76 @@
+//
+// Simulated clock with a configurable time-dilation factor.
+//
+
+#include <errno.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include "sim_clock.h"
+
+static __thread sim_sleep_hook sleep_hook = NULL;
+
+// Converts simulated seconds to a real-time timespec
+struct timespec sim_real_timespec(const SimClock *clock, double seconds) {
+    double real = seconds / clock->time_scale;
+    struct timespec ts;
+    ts.tv_sec = (time_t) real;
+    ts.tv_nsec = (long) ((real - (double) ts.tv_sec) * 1e9);
+    return ts;
+}
+
+void sim_clock_init(SimClock *clock, double time_scale) {
+    clock->time_scale = time_scale > 0 ? time_scale : 1.0;
+    clock_gettime(CLOCK_MONOTONIC, &clock->origin);
+}
+
+double sim_now(const SimClock *clock) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    double real = (double) (now.tv_sec - clock->origin.tv_sec) +
+                  (double) (now.tv_nsec - clock->origin.tv_nsec) / 1e9;
+    return real * clock->time_scale;
+}
+
+void sim_clock_set_sleep_hook(sim_sleep_hook hook) {
+    sleep_hook = hook;
+}
+
+double sim_sleep(const SimClock *clock, double seconds) {
+    if (sleep_hook) {
+        return sleep_hook(clock, seconds);
+    }
+    if (seconds <= 0) {
+        return 0;
+    }
+
+    struct timespec req = sim_real_timespec(clock, seconds);
+    struct timespec rem;
+    if (nanosleep(&req, &rem) == -1 && errno == EINTR) {
+        return ((double) rem.tv_sec + (double) rem.tv_nsec / 1e9) * clock->time_scale;
+    }
+    return 0;
+}
+
+int sim_clock_start_ticks(const SimClock *clock, double interval) {
+    struct timespec ts = sim_real_timespec(clock, interval);
+    struct itimerval timer;
+
+    timer.it_interval.tv_sec = ts.tv_sec;
+    timer.it_interval.tv_usec = ts.tv_nsec / 1000;
+    if (timer.it_interval.tv_sec == 0 && timer.it_interval.tv_usec == 0) {
+        timer.it_interval.tv_usec = 1;  // Smallest interval setitimer accepts
+    }
+    timer.it_value = timer.it_interval;
+
+    if (setitimer(ITIMER_REAL, &timer, NULL) == -1) {
+        perror("Failed to start clock ticks");
+        return -1;
+    }
+    return 0;
+}
+
+void sim_clock_stop_ticks(void) {
+    struct itimerval timer = {{0, 0}, {0, 0}};
+    setitimer(ITIMER_REAL, &timer, NULL);
+}
@@ -0,0 +1,183 @@
+//
+// Hierarchical timer wheel, see timer_wheel.h.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include "timer_wheel.h"
+
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TICK_EPSILON 1e-6  // Absorbs rounding in seconds -> ticks conversions
+
+static void unlink_timer(TimerWheel *wheel, int id) {
+    TimerEntry *timers = timer_wheel_timers(wheel);
+    TimerEntry *timer = &timers[id];
+
+    if (timer->prev != -1) {
+        timers[timer->prev].next = timer->next;
+    } else {
+        wheel->heads[timer->slot] = timer->next;
+    }
+    if (timer->next != -1) {
+        timers[timer->next].prev = timer->prev;
+    }
+
+    timer->next = -1;
+    timer->prev = -1;
+    timer->slot = -1;
+}
+
+// Picks the level from the distance to the current tick
+static void place_timer(TimerWheel *wheel, int id) {
+    TimerEntry *timers = timer_wheel_timers(wheel);
+    TimerEntry *timer = &timers[id];
+    uint64_t max_delta = (uint64_t) 1 << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS);
+
+    if (timer->expires - wheel->current_tick >= max_delta) {
+        timer->expires = wheel->current_tick + max_delta - 1;  // Clamp to the wheel's range
+    }
+
+    uint64_t delta = timer->expires - wheel->current_tick;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 &&
+           delta >= ((uint64_t) 1 << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+
+    int index = (int) ((timer->expires >> (TIMER_WHEEL_SLOT_BITS * level)) & SLOT_MASK);
+    int slot = level * TIMER_WHEEL_SLOTS + index;
+
+    timer->slot = slot;
+    timer->prev = -1;
+    timer->next = wheel->heads[slot];
+    if (timer->next != -1) {
+        timers[timer->next].prev = id;
+    }
+    wheel->heads[slot] = id;
+}
+
+// Moves every timer of a higher-level slot down to where it now belongs
+static void cascade(TimerWheel *wheel, int level, int index) {
+    TimerEntry *timers = timer_wheel_timers(wheel);
+    int slot = level * TIMER_WHEEL_SLOTS + index;
+    int id = wheel->heads[slot];
+    wheel->heads[slot] = -1;
+
+    while (id != -1) {
+        int next = timers[id].next;
+        place_timer(wheel, id);
+        id = next;
+    }
+}
+
+int timer_wheel_init(TimerWheel *wheel, TimerEntry *timers, int timer_count) {
+    if (sem_init(&wheel->lock, 1, 1) == -1) {
+        perror("Failed to initialize timer wheel lock");
+        return -1;
+    }
+
+    wheel->current_tick = 0;
+    for (int i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; i++) {
+        wheel->heads[i] = -1;
+    }
+    wheel->timer_count = timer_count;
+    wheel->timers = (char *) timers - (char *) wheel;
+    for (int i = 0; i < timer_count; i++) {
+        timers[i].next = -1;
+        timers[i].prev = -1;
+        timers[i].slot = -1;
+    }
+    return 0;
+}
+
+void timer_wheel_destroy(TimerWheel *wheel) {
+    sem_destroy(&wheel->lock);
+}
+
+int timer_wheel_schedule(TimerWheel *wheel, int timer_id, double expires_at) {
+    TimerEntry *timers = timer_wheel_timers(wheel);
+    if (timer_id < 0 || timer_id >= wheel->timer_count) {
+        fprintf(stderr, "Timer id %d out of range\n", timer_id);
+        return -1;
+    }
+
+    double ticks = ceil(expires_at / TIMER_WHEEL_TICK - TICK_EPSILON);
+    uint64_t expires = ticks > 0 ? (uint64_t) ticks : 0;
+
+    sem_wait(&wheel->lock);
+
+    if (timers[timer_id].slot != -1) {
+        unlink_timer(wheel, timer_id);
+    }
+
+    // Already due: fire on the next tick
+    if (expires <= wheel->current_tick) {
+        expires = wheel->current_tick + 1;
+    }
+    timers[timer_id].expires = expires;
+    place_timer(wheel, timer_id);
+
+    sem_post(&wheel->lock);
+    return 0;
+}
+
+int timer_wheel_cancel(TimerWheel *wheel, int timer_id) {
+    TimerEntry *timers = timer_wheel_timers(wheel);
+    if (timer_id < 0 || timer_id >= wheel->timer_count) {
+        return -1;
+    }
+
+    sem_wait(&wheel->lock);
+    int pending = timers[timer_id].slot != -1;
+    if (pending) {
+        unlink_timer(wheel, timer_id);
+    }
+    sem_post(&wheel->lock);
+
+    return pending ? 0 : -1;
+}
+
+int timer_wheel_advance(TimerWheel *wheel, double now, timer_callback callback, void *context) {
+    TimerEntry *timers = timer_wheel_timers(wheel);
+    uint64_t target = (uint64_t) floor(now / TIMER_WHEEL_TICK + TICK_EPSILON);
+    int fired = 0;
+
+    sem_wait(&wheel->lock);
+
+    while (wheel->current_tick < target) {
+        wheel->current_tick++;
+        uint64_t tick = wheel->current_tick;
+
+        // Level 0 wrapped: pull the next batch down from the upper levels
+        if ((tick & SLOT_MASK) == 0) {
+            for (int level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+                uint64_t lower = tick >> (TIMER_WHEEL_SLOT_BITS * level);
+                int wrapped = 1;
+                for (int l = 1; l < level; l++) {
+                    if (((tick >> (TIMER_WHEEL_SLOT_BITS * l)) & SLOT_MASK) != 0) {
+                        wrapped = 0;
+                        break;
+                    }
+                }
+                if (wrapped) {
+                    cascade(wheel, level, (int) (lower & SLOT_MASK));
+                }
+            }
+        }
+
+        int slot = (int) (tick & SLOT_MASK);
+        int id = wheel->heads[slot];
+        while (id != -1) {
+            int next = timers[id].next;
+            unlink_timer(wheel, id);
+            if (callback) {
+                callback(id, context);
+            }
+            fired++;
+            id = next;
+        }
+    }
+
+    sem_post(&wheel->lock);
+    return fired;
+}
@@ -0,0 +1,115 @@
+//
+// Per-item cost of the chef -> baker pipeline.
+//
+// Pushes ChefMessages through the same three hops the simulation uses (chef
+// worker -> chef manager -> dispatcher -> baker), one thread per hop, first
+// over System V message queues as the pipeline used to be and then over a
+// bake ChannelSet. Not a ctest; run it by hand:
+//
+//     bake-channel-bench [thousand messages]
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/msg.h>
+#include <time.h>
+#include "bakery_message.h"
+
+#define HOPS 3
+#define BENCH_SHM_NAME "/bake_channel_bench"
+
+typedef struct {
+    int queues[HOPS];
+    ChannelSet *channels;
+    int hop;                    // Stage reads hop and writes hop + 1
+} Stage;
+
+static void *queue_stage(void *arg) {
+    Stage *stage = arg;
+    ChefMessage msg;
+    do {
+        msgrcv(stage->queues[stage->hop], &msg, sizeof(msg) - sizeof(long), 0, 0);
+        if (stage->hop + 1 < HOPS) {
+            msgsnd(stage->queues[stage->hop + 1], &msg, sizeof(msg) - sizeof(long), 0);
+        }
+    } while (msg.product_index != -1);
+    return NULL;
+}
+
+static void *channel_stage(void *arg) {
+    Stage *stage = arg;
+    ChefMessage msg;
+    do {
+        channel_recv(stage->channels, stage->hop, &msg);
+        if (stage->hop + 1 < HOPS) {
+            channel_send(stage->channels, stage->hop + 1, &msg);
+        }
+    } while (msg.product_index != -1);
+    return NULL;
+}
+
+// Seconds for count messages and the end marker to reach the last hop
+static double run(Stage *proto, void *(*stage_fn)(void *), long count) {
+    pthread_t ids[HOPS];
+    Stage stages[HOPS];
+    struct timespec start, end;
+    ChefMessage msg = {.mtype = 1, .source_team = TEAM_BREAD, .product_name = "Baguette"};
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < HOPS; i++) {
+        stages[i] = *proto;
+        stages[i].hop = i;
+        pthread_create(&ids[i], NULL, stage_fn, &stages[i]);
+    }
+    for (long i = 0; i <= count; i++) {
+        msg.product_index = i < count ? (int) (i % 8) : -1;
+        if (proto->channels != NULL) {
+            channel_send(proto->channels, 0, &msg);
+        } else {
+            msgsnd(proto->queues[0], &msg, sizeof(msg) - sizeof(long), 0);
+        }
+    }
+    for (int i = 0; i < HOPS; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    long count = (argc > 1 ? atol(argv[1]) : 500) * 1000L;
+    if (count < 1) {
+        fprintf(stderr, "Usage: %s [thousand messages]\n", argv[0]);
+        return 1;
+    }
+
+    Stage queues = {.channels = NULL};
+    for (int i = 0; i < HOPS; i++) {
+        queues.queues[i] = msgget(IPC_PRIVATE, IPC_CREAT | 0600);
+        if (queues.queues[i] == -1) {
+            perror("msgget failed");
+            return 1;
+        }
+    }
+    double queue_time = run(&queues, queue_stage, count);
+    for (int i = 0; i < HOPS; i++) {
+        msgctl(queues.queues[i], IPC_RMID, NULL);
+    }
+
+    Stage channels = {.channels = channel_set_open(BENCH_SHM_NAME, HOPS, BAKE_CHANNEL_CAPACITY,
+                                                   sizeof(ChefMessage), 1)};
+    if (channels.channels == NULL) {
+        return 1;
+    }
+    shm_unlink(BENCH_SHM_NAME);
+    double channel_time = run(&channels, channel_stage, count);
+    channel_set_unmap(channels.channels);
+
+    printf("%ld messages over %d hops\n", count, HOPS);
+    printf("msg queues: %.3f s, %.2f us/item\n", queue_time, queue_time * 1e6 / count);
+    printf("channels:   %.3f s, %.2f us/item\n", channel_time, channel_time * 1e6 / count);
+    printf("speedup: %.1fx\n", queue_time / channel_time);
+    return 0;
+}
@@ -0,0 +1,44 @@
+//
+// Checks the batch summary against values worked out by hand.
+//
+
+#include <math.h>
+#include <stdio.h>
+#include "batch_stats.h"
+
+static int failures = 0;
+
+static void expect(const char *name, double actual, double expected) {
+    if (fabs(actual - expected) > 1e-3) {
+        printf("%s: got %.4f, expected %.4f\n", name, actual, expected);
+        failures++;
+    }
+}
+
+int main(void) {
+    // Unsorted on purpose: summarize_values sorts
+    double values[] = {7, 1, 9, 3, 5};
+    BatchSummary summary;
+    summarize_values(values, 5, &summary);
+
+    expect("mean", summary.mean, 5);
+    expect("stddev", summary.stddev, sqrt(10));
+    // t(4) = 2.776, half width = 2.776 * sqrt(10) / sqrt(5)
+    expect("ci_low", summary.ci_low, 5 - 2.776 * sqrt(2));
+    expect("ci_high", summary.ci_high, 5 + 2.776 * sqrt(2));
+    expect("min", summary.min, 1);
+    expect("p5", summary.p5, 1.4);
+    expect("p50", summary.p50, 5);
+    expect("p95", summary.p95, 8.6);
+    expect("max", summary.max, 9);
+
+    // A single run has no spread
+    double single[] = {42};
+    summarize_values(single, 1, &summary);
+    expect("single mean", summary.mean, 42);
+    expect("single ci_low", summary.ci_low, 42);
+    expect("single p95", summary.p95, 42);
+
+    printf("Batch stats test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
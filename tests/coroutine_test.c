@@ -0,0 +1,99 @@
+//
+// Runs many coroutines on one thread and checks that sim_sleep parks each
+// one until its own wake-up time, and that coro_msgrcv yields while its
+// queue is empty instead of blocking the other coroutines.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/msg.h>
+#include "coroutine.h"
+
+#define NUM_SLEEPERS 1000
+#define ROUNDS 5
+#define TIME_SCALE 1000.0    // 1 simulated second = 1 ms
+
+typedef struct {
+    long mtype;
+    int value;
+} TestMessage;
+
+static SimClock clock_;
+static int rounds_done[NUM_SLEEPERS];
+static int late_wakeups = 0;
+static int msg_queue = -1;
+static int received = -1;
+
+static void sleeper(void *arg) {
+    int id = (int) (long) arg;
+    double interval = 0.5 + (id % 7) * 0.25;
+
+    for (int i = 0; i < ROUNDS; i++) {
+        double wake_at = sim_now(&clock_) + interval;
+        sim_sleep(&clock_, interval);
+        if (sim_now(&clock_) < wake_at) {
+            late_wakeups++;   // Woke before its time
+        }
+        rounds_done[id]++;
+    }
+}
+
+static void receiver(void *arg) {
+    (void) arg;
+    TestMessage msg;
+    if (coro_msgrcv(msg_queue, &msg, sizeof(int), 1, 0) == sizeof(int)) {
+        received = msg.value;
+    }
+}
+
+static void sender(void *arg) {
+    (void) arg;
+    // Lets the receiver park on the empty queue first
+    sim_sleep(&clock_, 1);
+    TestMessage msg = {1, 42};
+    msgsnd(msg_queue, &msg, sizeof(int), 0);
+}
+
+int main(void) {
+    CoroScheduler scheduler;
+    int failures = 0;
+
+    sim_clock_init(&clock_, TIME_SCALE);
+    msg_queue = msgget(IPC_PRIVATE, 0600 | IPC_CREAT);
+    if (msg_queue == -1 || coro_scheduler_init(&scheduler, &clock_, NUM_SLEEPERS + 2) == -1) {
+        return 1;
+    }
+
+    coro_spawn(&scheduler, receiver, NULL);
+    for (long i = 0; i < NUM_SLEEPERS; i++) {
+        coro_spawn(&scheduler, sleeper, (void *) i);
+    }
+    coro_spawn(&scheduler, sender, NULL);
+
+    coro_scheduler_run(&scheduler);
+
+    for (int i = 0; i < NUM_SLEEPERS; i++) {
+        if (rounds_done[i] != ROUNDS) {
+            printf("Coroutine %d ran %d rounds, expected %d\n", i, rounds_done[i], ROUNDS);
+            failures++;
+        }
+    }
+    if (late_wakeups != 0) {
+        printf("%d wake-ups came early\n", late_wakeups);
+        failures++;
+    }
+    if (received != 42) {
+        printf("Receiver got %d, expected 42\n", received);
+        failures++;
+    }
+    if (coro_active()) {
+        printf("Still inside a coroutine after the run\n");
+        failures++;
+    }
+
+    coro_scheduler_destroy(&scheduler);
+    msgctl(msg_queue, IPC_RMID, NULL);
+
+    printf("Coroutine test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
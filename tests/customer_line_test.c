@@ -0,0 +1,142 @@
+//
+// Customers join the lanes of a three-seller line. Checks each seller takes
+// its own lane first in arrival order, steals from the other lanes once its
+// own is empty, never sees customers who left, that the manager's waiting
+// counts follow joins and leaves, that leaving from the middle of a lane
+// keeps the rest in order, that any number of joins and leaves fit, that an
+// order posted in a customer's slot reaches only the seller holding their
+// key, and that a seller asleep on its lane wakes for a customer joining it.
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "customer_line.h"
+#include "shared_mem_utils.h"
+
+static int failures = 0;
+static CustomerLine *line;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+static void join(int id, int lane) {
+    Customer customer = {.id = id, .pid = id + 1, .state = WAITING_IN_QUEUE};
+    check(customer_line_join(line, &customer, lane) == 0, "Join failed");
+}
+
+// Key of the next customer lane's seller takes, 0 if none
+static pid_t next_key(int lane) {
+    struct timespec timeout = {0, 10 * 1000 * 1000};
+    Customer customer;
+    return customer_line_next(line, lane, &customer, &timeout) == 0 ? customer.pid : 0;
+}
+
+static void *late_join(void *arg) {
+    (void) arg;
+    usleep(50000);
+    join(7, 1);
+    return NULL;
+}
+
+int main(void) {
+    ipc_set_instance((unsigned int) getpid());
+    Config config = {.MAX_CUSTOMERS = 8, .NUM_SELLERS = 3};
+    line = customer_line_open(&config, 1);
+    if (line == NULL) {
+        return 1;
+    }
+    shm_unlink(CUSTOMER_QUEUE_SHM_NAME);
+
+    join(0, 0);
+    join(1, 0);
+    join(2, 1);
+    join(3, 0);
+    check(customer_line_waiting(line, 0) == 3 && customer_line_waiting(line, 1) == 1 &&
+          customer_line_waiting(line, 2) == 0, "Waiting counts do not follow the joins");
+
+    // Customer 1 leaves before a seller gets to them
+    check(customer_line_leave(line, 2) == 0, "Leave failed");
+    check(customer_line_waiting(line, 0) == 2, "Leaving did not shorten the lane");
+
+    check(next_key(0) == 1, "Seller 0 did not take the head of its lane");
+    check(next_key(1) == 3, "Seller 1 did not take its own lane");
+    // Seller 2's lane is empty: it helps out with lane 0, skipping customer 1
+    check(next_key(2) == 4, "Seller 2 did not steal from lane 0");
+    check(next_key(0) == 0, "A customer was handed out twice");
+
+    // Taking a customer leaves the count alone: the manager drops them from
+    // the line once the seller's call reaches it
+    check(customer_line_waiting(line, 0) == 2, "A seller changed the waiting count");
+    customer_line_leave(line, 1);
+    customer_line_leave(line, 4);
+    customer_line_leave(line, 3);
+    check(customer_line_waiting(line, 0) == 0 && customer_line_waiting(line, 1) == 0,
+          "Lanes are not empty after everyone left");
+
+    // The middle customer of a lane leaves; the walk and the seller skip them
+    join(8, 2);
+    join(9, 2);
+    join(10, 2);
+    customer_line_leave(line, 10);
+    Customer lane[8];
+    check(customer_line_lane_snapshot(line, 2, lane, 8) == 2 && lane[0].id == 8 && lane[1].id == 10,
+          "Lane walk does not follow the line after a mid-line leave");
+    check(next_key(2) == 9 && next_key(2) == 11, "Seller did not skip the customer who left");
+    customer_line_leave(line, 9);
+    customer_line_leave(line, 11);
+
+    // Far more customers than the line holds come and go through one slot
+    for (int round = 0; round < 1000; round++) {
+        join(8 * round + 3, 0);
+        customer_line_leave(line, 8 * round + 4);
+    }
+    check(customer_line_waiting(line, 0) == 0 && next_key(0) == 0, "Churn left customers in the line");
+
+    // The order goes through the called customer's slot
+    ShmRef ref;
+    join(16, 0);
+    check(next_key(0) == 17, "Seller did not take the new customer");
+    check(customer_line_waiting(line, 0) == 1, "Taken customer stopped counting before the call");
+    customer_line_called(line, 17);
+    check(customer_line_waiting(line, 0) == 0, "Called customer still counts as waiting");
+    check(customer_line_take_order(line, 17, &ref) == 0, "Order taken before it was posted");
+    customer_line_post_order(line, 17, 1234);
+    check(customer_line_take_order(line, 17, &ref) == 1 && ref == 1234, "Posted order not taken");
+    check(customer_line_take_order(line, 17, &ref) == 0, "Order taken twice");
+    check(customer_line_present(line, 17), "Customer waiting for products counted as gone");
+    customer_line_leave(line, 17);
+    check(customer_line_take_order(line, 17, &ref) == -1, "Seller did not notice the customer left");
+
+    // The slot's next customer keeps their order from the old key
+    join(24, 0);
+    customer_line_post_order(line, 25, 99);
+    check(customer_line_take_order(line, 17, &ref) == -1, "Stale key took another customer's order");
+    check(!customer_line_present(line, 17) && customer_line_present(line, 25),
+          "Stale key counts as the slot's next customer");
+    customer_line_leave(line, 25);
+
+    // A seller asleep on its empty lane wakes when a customer joins it
+    pthread_t joiner;
+    struct timespec start, end, timeout = {5, 0};
+    Customer customer;
+    pthread_create(&joiner, NULL, late_join, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int result = customer_line_next(line, 1, &customer, &timeout);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_join(joiner, NULL);
+    double waited = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    check(result == 0 && customer.pid == 8 && waited < 2.0, "Sleeping seller did not wake for a join");
+
+    customer_line_close(line, &config);
+    if (failures != 0) {
+        return 1;
+    }
+    printf("Customer line test passed\n");
+    return 0;
+}
@@ -0,0 +1,60 @@
+//
+// Checks that the event calendar pops events in (time, insertion) order.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "event_queue.h"
+
+int main(void) {
+    EventQueue queue;
+    if (event_queue_init(&queue, 2) == -1) {
+        return 1;
+    }
+
+    // Push more events than the initial capacity to force growth
+    srand(42);
+    for (int i = 0; i < 1000; i++) {
+        event_queue_push(&queue, (double) (rand() % 100), 0, i, 0);
+    }
+    // Two events at the same instant must keep their push order
+    event_queue_push(&queue, 50.0, 1, 2000, 0);
+    event_queue_push(&queue, 50.0, 1, 2001, 0);
+
+    SimEvent previous, event;
+    int failures = 0;
+    int popped = 0;
+    int tie_order = -1;
+
+    while (event_queue_pop(&queue, &event) == 0) {
+        if (popped > 0 && (event.time < previous.time ||
+                           (event.time == previous.time && event.seq < previous.seq))) {
+            printf("Out of order: t=%.1f seq=%lu after t=%.1f seq=%lu\n",
+                   event.time, event.seq, previous.time, previous.seq);
+            failures++;
+        }
+        if (event.actor == 2000 || event.actor == 2001) {
+            if (event.actor == 2001 && tie_order != 2000) {
+                printf("Same-time events popped out of insertion order\n");
+                failures++;
+            }
+            tie_order = event.actor;
+        }
+        previous = event;
+        popped++;
+    }
+
+    if (popped != 1002) {
+        printf("Expected 1002 events, popped %d\n", popped);
+        failures++;
+    }
+    if (!event_queue_is_empty(&queue) || event_queue_pop(&queue, &event) != -1) {
+        printf("Queue should be empty\n");
+        failures++;
+    }
+
+    event_queue_destroy(&queue);
+
+    printf("Event queue test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
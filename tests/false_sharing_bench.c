@@ -0,0 +1,97 @@
+//
+// False-sharing benchmark for the per-actor slots in Game.
+//
+// Each thread updates only its own baker slot, first in an array laid out
+// like the old packed Baker struct and then in the game's baker slots. The
+// writes never conflict logically; any slowdown in the packed run is cache
+// lines bouncing between cores. Not a ctest; run it by hand:
+//
+//     false-sharing-bench [threads] [million writes per thread]
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "game.h"
+
+#define MAX_THREADS 20
+
+// Baker as it was before the slots were cache aligned
+typedef struct {
+    Team team_name;
+    State state;
+    char Item[MAX_NAME_LENGTH];
+} PackedBaker;
+
+typedef struct {
+    volatile State *state;
+    long writes;
+} WorkerArgs;
+
+static void *worker(void *arg) {
+    WorkerArgs *args = arg;
+    for (long i = 0; i < args->writes; i++) {
+        *args->state = (i & 1) ? BAKER_BUSY : BAKER_IDLE;
+    }
+    return NULL;
+}
+
+// Seconds for every thread to do its writes to its own state field
+static double run(volatile State **states, int threads, long writes) {
+    pthread_t ids[MAX_THREADS];
+    WorkerArgs args[MAX_THREADS];
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < threads; i++) {
+        args[i].state = states[i];
+        args[i].writes = writes;
+        pthread_create(&ids[i], NULL, worker, &args[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    int threads = argc > 1 ? atoi(argv[1]) : 4;
+    long writes = (argc > 2 ? atol(argv[2]) : 50) * 1000000L;
+    if (threads < 1 || threads > MAX_THREADS || writes < 1) {
+        fprintf(stderr, "Usage: %s [threads 1-%d] [million writes per thread]\n", argv[0], MAX_THREADS);
+        return 1;
+    }
+
+    void *packed_memory = NULL;
+    posix_memalign(&packed_memory, CACHE_LINE, sizeof(PackedBaker) * MAX_THREADS);
+    PackedBaker *packed = packed_memory;
+    Config config = {.NUM_BAKERS = threads};
+    Game *game = game_alloc(&config, NULL);
+    if (packed == NULL || game == NULL) {
+        perror("Failed to allocate");
+        return 1;
+    }
+
+    volatile State *states[MAX_THREADS];
+    for (int i = 0; i < threads; i++) {
+        states[i] = &packed[i].state;
+    }
+    double packed_time = run(states, threads, writes);
+
+    for (int i = 0; i < threads; i++) {
+        states[i] = &game_baker(game, i)->state;
+    }
+    double aligned_time = run(states, threads, writes);
+
+    double total = (double) threads * writes;
+    printf("%d threads, %ld writes each\n", threads, writes);
+    printf("packed  (%2zu B/slot): %.3f s, %.2f ns/write\n", sizeof(PackedBaker), packed_time, packed_time * 1e9 / total);
+    printf("aligned (%2zu B/slot): %.3f s, %.2f ns/write\n", sizeof(Baker), aligned_time, aligned_time * 1e9 / total);
+    printf("speedup: %.1fx\n", packed_time / aligned_time);
+
+    free(packed);
+    free(game);
+    return 0;
+}
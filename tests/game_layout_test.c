@@ -0,0 +1,226 @@
+//
+// Checks the Game segment layout: every region written by a different
+// process starts on its own cache line, and no two per-actor slots share
+// a line. The static asserts fail the build; the runtime checks cover the
+// slot and product arrays, which are sized from the config and the catalog
+// and follow the fixed part.
+//
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+#include "semaphores_utils.h"
+
+#define LINE_OF(field) (offsetof(Game, field) / CACHE_LINE)
+#define ALIGNED(field) (offsetof(Game, field) % CACHE_LINE == 0)
+
+_Static_assert(ALIGNED(elapsed_time), "clock thread region must start a cache line");
+_Static_assert(ALIGNED(complaining_customer_pid), "complaint region must start a cache line");
+_Static_assert(ALIGNED(inventory), "inventory must start a cache line");
+_Static_assert(ALIGNED(ready_products), "ready products must start a cache line");
+_Static_assert(ALIGNED(oven_timers), "oven timers must start a cache line");
+_Static_assert(ALIGNED(stats), "stat shards must start a cache line");
+
+_Static_assert(sizeof(Chef) % CACHE_LINE == 0, "a chef slot must fill whole lines");
+_Static_assert(sizeof(Baker) % CACHE_LINE == 0, "a baker slot must fill whole lines");
+_Static_assert(sizeof(Seller) % CACHE_LINE == 0, "a seller slot must fill whole lines");
+_Static_assert(sizeof(Oven) % CACHE_LINE == 0, "an oven slot must fill whole lines");
+
+// Read-mostly data must not share a line with anything written later on
+_Static_assert(offsetof(Game, clock) + sizeof(SimClock) <= offsetof(Game, elapsed_time),
+               "read-mostly region overlaps the clock thread region");
+_Static_assert(LINE_OF(game_over) < LINE_OF(complaining_customer_pid),
+               "clock thread and customer manager share a line");
+
+// Lines [first, last] covered by an object at offset with the given size
+static void lines(size_t offset, size_t size, size_t *first, size_t *last) {
+    *first = offset / CACHE_LINE;
+    *last = (offset + size - 1) / CACHE_LINE;
+}
+
+static int check_slots(const char *name, size_t base, size_t size, int count) {
+    int failures = 0;
+    for (int i = 1; i < count; i++) {
+        size_t first, last, prev_first, prev_last;
+        lines(base + (i - 1) * size, size, &prev_first, &prev_last);
+        lines(base + i * size, size, &first, &last);
+        if (first <= prev_last) {
+            printf("%s %d and %d share cache line %zu\n", name, i - 1, i, first);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// Slot arrays of a game laid out for the given staff: aligned, in bounds,
+// not overlapping, and where the accessors point
+static int check_layout(int chefs, int bakers, int sellers, int ovens) {
+    Config config = {0};
+    config.NUM_CHEFS = chefs;
+    config.NUM_BAKERS = bakers;
+    config.NUM_SELLERS = sellers;
+    config.NUM_OVENS = ovens;
+
+    Game *game = game_alloc(&config, NULL);
+    if (game == NULL || (size_t) game % CACHE_LINE != 0) {
+        printf("game_alloc did not return a cache-line-aligned Game\n");
+        free(game);
+        return 1;
+    }
+
+    int failures = 0;
+    const GameLayout *layout = &game->layout;
+    if (!game_layout_valid(game) || layout->size != game_size(&config, NULL) ||
+        layout->chef_slots != chefs || layout->baker_slots != bakers ||
+        layout->seller_slots != sellers || layout->oven_slots != ovens) {
+        printf("Header does not describe %d/%d/%d/%d slots\n", chefs, bakers, sellers, ovens);
+        failures++;
+    }
+
+    struct { const char *name; size_t offset, size; int count; } arrays[] = {
+        {"Chef", layout->chefs, sizeof(Chef), layout->chef_slots},
+        {"Baker", layout->bakers, sizeof(Baker), layout->baker_slots},
+        {"Seller", layout->sellers, sizeof(Seller), layout->seller_slots},
+        {"Oven", layout->ovens, sizeof(Oven), layout->oven_slots},
+    };
+    size_t end = sizeof(Game);
+    for (int i = 0; i < 4; i++) {
+        if (arrays[i].offset % CACHE_LINE != 0 || arrays[i].offset < end) {
+            printf("%s slots at %zu overlap or are misaligned\n", arrays[i].name, arrays[i].offset);
+            failures++;
+        }
+        failures += check_slots(arrays[i].name, arrays[i].offset, arrays[i].size, arrays[i].count);
+        end = arrays[i].offset + arrays[i].size * arrays[i].count;
+    }
+    if (end > layout->size) {
+        printf("Slots run past the end of the segment\n");
+        failures++;
+    }
+
+    if ((char *) game_chef(game, chefs - 1) != (char *) game + layout->chefs + (chefs - 1) * sizeof(Chef) ||
+        (char *) game_oven(game, ovens - 1) + sizeof(Oven) > (char *) game + layout->size) {
+        printf("Slot accessors do not match the header\n");
+        failures++;
+    }
+    // Every slot is writable memory of this game
+    game_oven(game, ovens - 1)->id = ovens - 1;
+    game_baker(game, bakers - 1)->state = BAKER_BUSY;
+
+    printf("%4d chefs, %4d bakers, %4d sellers, %4d ovens: %zu bytes\n",
+           chefs, bakers, sellers, ovens, layout->size);
+    free(game);
+    return failures;
+}
+
+// A factory's worth of ovens: each gets a slot and a timer of its own,
+// between the other slots and the products, and the last one can be timed
+static int check_many_ovens(int ovens) {
+    Config config = {.NUM_CHEFS = 1, .NUM_BAKERS = 1, .NUM_SELLERS = 1, .NUM_OVENS = ovens};
+    Game *game = game_alloc(&config, NULL);
+    if (game == NULL || game_reset(game) == -1) {
+        free(game);
+        return 1;
+    }
+
+    int failures = 0;
+    const GameLayout *layout = &game->layout;
+    size_t ovens_end = layout->ovens + (size_t) layout->oven_slots * sizeof(Oven);
+    size_t timers_end = layout->oven_timers + (size_t) layout->oven_slots * sizeof(TimerEntry);
+    if (layout->oven_slots != ovens || game->oven_timers.timer_count != ovens ||
+        layout->oven_timers < ovens_end || timers_end > layout->products ||
+        (char *) timer_wheel_timers(&game->oven_timers) != (char *) game + layout->oven_timers) {
+        printf("%d ovens do not each get a slot and a timer\n", ovens);
+        failures++;
+    }
+    if (timer_wheel_schedule(&game->oven_timers, ovens - 1, 1.0) == -1 ||
+        timer_wheel_advance(&game->oven_timers, 1.0, NULL, NULL) != 1) {
+        printf("Oven %d cannot be timed\n", ovens - 1);
+        failures++;
+    }
+
+    timer_wheel_destroy(&game->oven_timers);
+    shared_mutex_destroy(&game->ready_products.lock);
+    free(game);
+    return failures;
+}
+
+// A catalog with more products per category than the old fixed arrays held:
+// copied in after the slots, each product with a ready count of its own
+static int check_products(int per_category) {
+    ProductCatalog catalog = {.category_count = 2};
+    catalog.categories[0].type = CAKE;  // Catalog order need not follow the types
+    catalog.categories[1].type = BREAD;
+    for (int i = 0; i < catalog.category_count; i++) {
+        catalog.categories[i].products = calloc(per_category, sizeof(Product));
+        catalog.categories[i].product_count = per_category;
+        for (int j = 0; catalog.categories[i].products != NULL && j < per_category; j++) {
+            snprintf(catalog.categories[i].products[j].name, MAX_NAME_LENGTH, "product %d-%d", i, j);
+        }
+    }
+    Config config = {.NUM_CHEFS = 2, .NUM_BAKERS = 2, .NUM_SELLERS = 1, .NUM_OVENS = 1};
+    Game *game = game_alloc(&config, &catalog);
+    for (int i = 0; i < catalog.category_count; i++) {
+        free(catalog.categories[i].products);
+    }
+    if (game == NULL || game_reset(game) == -1) {
+        printf("Could not lay out %d products per category\n", per_category);
+        free(game);
+        return 1;
+    }
+
+    int failures = 0;
+    const GameLayout *layout = &game->layout;
+    size_t slots_end = layout->ovens + (size_t) layout->oven_slots * sizeof(Oven);
+    size_t products_end = layout->products + (size_t) layout->product_slots * sizeof(Product);
+    if (layout->product_slots != 2 * per_category || layout->products % CACHE_LINE != 0 ||
+        layout->ready % CACHE_LINE != 0 || layout->products < slots_end || layout->ready < products_end ||
+        layout->ready + (size_t) layout->product_slots * sizeof(int) > layout->size) {
+        printf("Product arrays for %d products per category overlap or run past the end\n", per_category);
+        failures++;
+    }
+
+    char expected[MAX_NAME_LENGTH];
+    snprintf(expected, sizeof(expected), "product 1-%d", per_category - 1);
+    if (game_product_count(game, 1) != per_category || strcmp(game_product(game, 1, per_category - 1)->name, expected) != 0) {
+        printf("Last product is not where game_product looks\n");
+        failures++;
+    }
+
+    ReadyProducts *ready = &game->ready_products;
+    add_ready_product(ready, BREAD, per_category - 1, 2);
+    if (ready_quantities(ready) != game_ready_quantities(game) ||
+        game_ready_quantities(game)[ready->categories[BREAD].first + per_category - 1] != 2 ||
+        ready->total_count != 2 || get_ready_product(ready, BREAD, per_category, 1) != 0) {
+        printf("Ready count of product %d is not kept in the segment\n", per_category - 1);
+        failures++;
+    }
+
+    shared_mutex_destroy(&ready->lock);
+    free(game);
+    return failures;
+}
+
+int main(void) {
+    int failures = 0;
+
+    failures += check_slots("Stat shard", offsetof(Game, stats.shards), sizeof(StatShard), MAX_STAT_SHARDS);
+    failures += check_layout(5, 4, 2, 3);
+    failures += check_layout(300, 200, 40, 500);
+
+    failures += check_many_ovens(5000);
+    failures += check_products(3);
+    failures += check_products(100);
+
+    Config small = {.NUM_CHEFS = 5, .NUM_BAKERS = 4, .NUM_SELLERS = 2, .NUM_OVENS = 3};
+    Config factory = {.NUM_CHEFS = 300, .NUM_BAKERS = 200, .NUM_SELLERS = 40, .NUM_OVENS = 500};
+    if (game_size(&small, NULL) >= game_size(&factory, NULL)) {
+        printf("A small bakery does not get a smaller segment\n");
+        failures++;
+    }
+
+    printf("Fixed part: %zu bytes (%zu lines)\n", sizeof(Game), sizeof(Game) / CACHE_LINE);
+    printf("Game layout test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
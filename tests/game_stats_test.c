@@ -0,0 +1,93 @@
+//
+// Several processes, each with several threads, add to one shared GameStats.
+// Checks the summed counters and profit are exact and that writers spread
+// over distinct shards.
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "game_stats.h"
+
+#define NUM_PROCESSES 4
+#define THREADS_PER_PROCESS 4
+#define ADDS 100000
+
+static GameStats *stats;
+
+static void *writer(void *arg) {
+    (void) arg;
+    for (int i = 0; i < ADDS; i++) {
+        stats_add(stats, STAT_SERVED, 1);
+        stats_add(stats, STAT_MISSING, 2);
+        stats_add_profit(stats, 1.25f);
+    }
+    return NULL;
+}
+
+static void run_writers(void) {
+    pthread_t threads[THREADS_PER_PROCESS];
+    for (int i = 0; i < THREADS_PER_PROCESS; i++) {
+        pthread_create(&threads[i], NULL, writer, NULL);
+    }
+    for (int i = 0; i < THREADS_PER_PROCESS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+int main(void) {
+    int failures = 0;
+
+    stats = mmap(NULL, sizeof(GameStats), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (stats == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    stats_reset(stats);
+
+    // The parent writes before forking, so children must not reuse its shard
+    stats_add(stats, STAT_CASCADE, 1);
+
+    for (int i = 0; i < NUM_PROCESSES; i++) {
+        if (fork() == 0) {
+            stats_add(stats, STAT_CASCADE, 1);
+            run_writers();
+            _exit(0);
+        }
+    }
+    while (wait(NULL) > 0) {
+    }
+
+    long writers = NUM_PROCESSES * THREADS_PER_PROCESS;
+    if (stats_read(stats, STAT_SERVED) != writers * ADDS) {
+        printf("Served %lld, expected %ld\n", (long long) stats_read(stats, STAT_SERVED), writers * ADDS);
+        failures++;
+    }
+    if (stats_read(stats, STAT_MISSING) != 2 * writers * ADDS) {
+        printf("Missing %lld, expected %ld\n", (long long) stats_read(stats, STAT_MISSING), 2 * writers * ADDS);
+        failures++;
+    }
+    if (stats_read(stats, STAT_PROFIT) != 125 * writers * ADDS) {
+        printf("Profit %.2f, expected %.2f\n", stats_profit(stats), 1.25 * writers * ADDS);
+        failures++;
+    }
+
+    // One shard for the parent, one per child process and one per thread
+    int expected_shards = 1 + NUM_PROCESSES * (1 + THREADS_PER_PROCESS);
+    if (stats->next_shard != expected_shards) {
+        printf("%d shards claimed, expected %d\n", stats->next_shard, expected_shards);
+        failures++;
+    }
+    for (int i = 0; i < MAX_STAT_SHARDS; i++) {
+        if (stats->shards[i].values[STAT_CASCADE] > 1) {
+            printf("Shard %d was shared by a parent and its child\n", i);
+            failures++;
+        }
+    }
+
+    munmap(stats, sizeof(GameStats));
+    printf("Game stats test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
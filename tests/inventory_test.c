@@ -0,0 +1,158 @@
+//
+// Hammers the lock-free inventory from several threads: chefs reserve a
+// recipe while supply chains add ingredients. Checks that stock never goes
+// negative and that every unit is accounted for, which also fails if a
+// reservation ever keeps part of a recipe. A second round runs against a
+// small capacity and checks that putting back a failed reservation never
+// lifts the stock past it.
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include "inventory.h"
+
+#define NUM_CHEFS 4
+#define NUM_SUPPLIERS 2
+#define RESERVATIONS 200000
+#define DELIVERIES 100000
+#define INITIAL_RECIPES 1000   // Stock on hand before any thread starts
+#define SMALL_CAPACITY 4       // Capacity of the capped round, in units
+
+static Inventory inventory;
+static const Ingredient recipe[] = {{WHEAT, 1.5f}, {YEAST, 0.25f}, {BUTTER, 2.0f}};
+static const int recipe_size = sizeof(recipe) / sizeof(recipe[0]);
+static int supplied;   // How many recipe ingredients the suppliers deliver
+static int top_up;     // Suppliers keep delivering until the chefs are done
+static int reserved[NUM_CHEFS];
+static int done = 0;
+static int negative_seen = 0;
+static int overflow_seen = 0;
+static int chefs_running = 0;
+
+// Flags stock outside [0, max_capacity]
+static void check_stock(void) {
+    for (int i = 0; i < NUM_INGREDIENTS; i++) {
+        int64_t stock = __atomic_load_n(&inventory.stock[i], __ATOMIC_ACQUIRE);
+        if (stock < 0) {
+            negative_seen = 1;
+        }
+        if (stock > (int64_t) inventory.max_capacity * INVENTORY_SCALE) {
+            overflow_seen = 1;
+        }
+    }
+}
+
+static void *chef(void *arg) {
+    int id = (int) (long) arg;
+    for (int i = 0; i < RESERVATIONS; i++) {
+        if (reserve_ingredients(&inventory, recipe, recipe_size)) {
+            reserved[id]++;
+        } else {
+            check_stock();   // Right after a rollback, before a delivery can cap it
+        }
+    }
+    __atomic_sub_fetch(&chefs_running, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *supplier(void *arg) {
+    (void) arg;
+    for (int i = 0; i < DELIVERIES || (top_up && __atomic_load_n(&chefs_running, __ATOMIC_ACQUIRE)); i++) {
+        for (int j = 0; j < supplied; j++) {
+            add_ingredient(&inventory, recipe[j].type, recipe[j].quantity * 2);
+        }
+    }
+    return NULL;
+}
+
+static void *watcher(void *arg) {
+    (void) arg;
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+        check_stock();
+    }
+    return NULL;
+}
+
+// With starve_last the last ingredient never arrives, so every reservation
+// puts back what it took while the suppliers keep the rest topped up
+static long run_round(int max_capacity, int initial_recipes, int starve_last) {
+    pthread_t chefs[NUM_CHEFS], suppliers[NUM_SUPPLIERS], watch;
+
+    init_inventory(&inventory);
+    inventory.max_capacity = max_capacity;
+    supplied = starve_last ? recipe_size - 1 : recipe_size;
+    top_up = starve_last;
+    for (int j = 0; j < recipe_size; j++) {
+        add_ingredient(&inventory, recipe[j].type, recipe[j].quantity * initial_recipes);
+    }
+    for (int i = 0; i < NUM_CHEFS; i++) {
+        reserved[i] = 0;
+    }
+    __atomic_store_n(&chefs_running, NUM_CHEFS, __ATOMIC_RELEASE);
+    __atomic_store_n(&done, 0, __ATOMIC_RELEASE);
+    negative_seen = overflow_seen = 0;
+
+    pthread_create(&watch, NULL, watcher, NULL);
+    for (long i = 0; i < NUM_CHEFS; i++) {
+        pthread_create(&chefs[i], NULL, chef, (void *) i);
+    }
+    for (long i = 0; i < NUM_SUPPLIERS; i++) {
+        pthread_create(&suppliers[i], NULL, supplier, NULL);
+    }
+    for (int i = 0; i < NUM_CHEFS; i++) {
+        pthread_join(chefs[i], NULL);
+    }
+    for (int i = 0; i < NUM_SUPPLIERS; i++) {
+        pthread_join(suppliers[i], NULL);
+    }
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    pthread_join(watch, NULL);
+
+    long total_reserved = 0;
+    for (int i = 0; i < NUM_CHEFS; i++) {
+        total_reserved += reserved[i];
+    }
+    return total_reserved;
+}
+
+int main(void) {
+    int failures = 0;
+
+    // No capping, so every delivery counts
+    long total_reserved = run_round(1 << 30, INITIAL_RECIPES, 0);
+
+    // Stocked and delivered minus reserved must be exactly what is left, per ingredient
+    for (int j = 0; j < recipe_size; j++) {
+        int64_t step = (int64_t) (recipe[j].quantity * INVENTORY_SCALE);
+        int64_t expected = step * (INITIAL_RECIPES + 2L * NUM_SUPPLIERS * DELIVERIES - total_reserved);
+        if (inventory.stock[recipe[j].type] != expected) {
+            printf("Ingredient %d: %lld left, expected %lld\n", recipe[j].type,
+                   (long long) inventory.stock[recipe[j].type], (long long) expected);
+            failures++;
+        }
+    }
+    if (negative_seen) {
+        printf("Stock went negative\n");
+        failures++;
+    }
+    if (total_reserved == 0) {
+        printf("No reservation ever succeeded\n");
+        failures++;
+    }
+
+    printf("%ld of %d reservations succeeded\n", total_reserved, NUM_CHEFS * RESERVATIONS);
+
+    // Failed reservations put back what they took into stock kept at capacity
+    run_round(SMALL_CAPACITY, 0, 1);
+    if (overflow_seen) {
+        printf("Stock went past max_capacity\n");
+        failures++;
+    }
+    if (negative_seen) {
+        printf("Stock went negative with a small capacity\n");
+        failures++;
+    }
+
+    printf("Inventory test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
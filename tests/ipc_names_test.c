@@ -0,0 +1,68 @@
+//
+// Checks that two run instances never share a name or key, and that a
+// child started with exec picks up its parent's instance.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "ipc_names.h"
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Child mode: print what the inherited environment resolves to
+    if (argc > 1 && strcmp(argv[1], "--child") == 0) {
+        return ipc_instance() == 4242 && strcmp(ipc_name(IPC_GAME_SHM), "/game_shared_mem_4242") == 0 ? 0 : 1;
+    }
+
+    char first_names[IPC_NAME_COUNT][64];
+    key_t first_keys[IPC_KEY_COUNT];
+
+    ipc_set_instance(1);
+    for (int i = 0; i < IPC_NAME_COUNT; i++) {
+        strcpy(first_names[i], ipc_name(i));
+        check(first_names[i][0] == '/', "Names must start with /");
+    }
+    for (int i = 0; i < IPC_KEY_COUNT; i++) {
+        first_keys[i] = ipc_key(i);
+    }
+
+    ipc_set_instance(2);
+    for (int i = 0; i < IPC_NAME_COUNT; i++) {
+        for (int j = 0; j < IPC_NAME_COUNT; j++) {
+            check(strcmp(first_names[i], ipc_name(j)) != 0, "Two instances share a name");
+        }
+    }
+    for (int i = 0; i < IPC_KEY_COUNT; i++) {
+        for (int j = 0; j < IPC_KEY_COUNT; j++) {
+            check(first_keys[i] != ipc_key(j), "Two instances share a key");
+            if (i != j) {
+                check(first_keys[i] != first_keys[j], "Two keys of one instance collide");
+            }
+        }
+    }
+
+    // The instance reaches exec'd children through the environment
+    ipc_set_instance(4242);
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/proc/self/exe", argv[0], "--child", NULL);
+        _exit(2);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Child did not inherit the instance");
+
+    printf("IPC names test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
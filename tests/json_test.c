@@ -185,6 +185,7 @@ int main() {
     if (result == 0) {
         printf("Successfully loaded product catalog!\n");
         print_product_catalog(&catalog);
+        free_product_catalog(&catalog);
     } else {
         printf("Failed to load product catalog. Error code: %d\n", result);
     }
@@ -0,0 +1,134 @@
+//
+// Producers and consumers hammer a small ring so it keeps wrapping, full and
+// empty. Checks every element comes out exactly once, in its producer's
+// order, and that a consumer sleeping on an empty ring wakes for a push and
+// times out without one.
+//
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "mpmc_ring.h"
+
+#define NUM_PRODUCERS 3
+#define NUM_CONSUMERS 3
+#define PER_PRODUCER 200000
+#define CAPACITY 64
+
+static MpmcRing *ring;
+static unsigned char seen[NUM_PRODUCERS][PER_PRODUCER];
+static int producers_done = 0;
+static long out_of_order = 0;
+
+static void *producer(void *arg) {
+    uint32_t id = (uint32_t) (long) arg;
+    for (uint32_t i = 0; i < PER_PRODUCER; i++) {
+        uint32_t value = id << 24 | i;
+        while (mpmc_ring_push(ring, &value) == -1) {
+            sched_yield();
+        }
+    }
+    __atomic_add_fetch(&producers_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    (void) arg;
+    int last[NUM_PRODUCERS] = {-1, -1, -1};
+    struct timespec timeout = {0, 10 * 1000 * 1000};
+    uint32_t value;
+
+    for (;;) {
+        if (mpmc_ring_pop_wait(ring, &value, &timeout) == -1) {
+            if (__atomic_load_n(&producers_done, __ATOMIC_ACQUIRE) == NUM_PRODUCERS &&
+                mpmc_ring_count(ring) == 0) {
+                break;
+            }
+            continue;
+        }
+
+        uint32_t id = value >> 24;
+        int i = (int) (value & 0xffffff);
+        __atomic_add_fetch(&seen[id][i], 1, __ATOMIC_RELAXED);
+        // One producer's elements come out in the order it pushed them
+        if (i <= last[id]) {
+            __atomic_add_fetch(&out_of_order, 1, __ATOMIC_RELAXED);
+        }
+        last[id] = i;
+    }
+    return NULL;
+}
+
+static void *late_pusher(void *arg) {
+    (void) arg;
+    usleep(50000);
+    uint32_t value = 7;
+    mpmc_ring_push(ring, &value);
+    return NULL;
+}
+
+int main(void) {
+    if (posix_memalign((void **) &ring, CACHE_LINE, mpmc_ring_size(sizeof(uint32_t), CAPACITY)) != 0 ||
+        mpmc_ring_init(ring, sizeof(uint32_t), CAPACITY) == -1) {
+        return 1;
+    }
+    if (mpmc_ring_capacity(100) != 128 || mpmc_ring_init(ring, sizeof(uint32_t), 100) != -1) {
+        printf("Capacities are not rounded to powers of two\n");
+        return 1;
+    }
+    mpmc_ring_init(ring, sizeof(uint32_t), CAPACITY);
+
+    pthread_t producers[NUM_PRODUCERS], consumers[NUM_CONSUMERS];
+    for (long i = 0; i < NUM_CONSUMERS; i++) {
+        pthread_create(&consumers[i], NULL, consumer, (void *) i);
+    }
+    for (long i = 0; i < NUM_PRODUCERS; i++) {
+        pthread_create(&producers[i], NULL, producer, (void *) i);
+    }
+    for (int i = 0; i < NUM_PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (int i = 0; i < NUM_CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+
+    long missing = 0, duplicated = 0;
+    for (int p = 0; p < NUM_PRODUCERS; p++) {
+        for (int i = 0; i < PER_PRODUCER; i++) {
+            missing += seen[p][i] == 0;
+            duplicated += seen[p][i] > 1;
+        }
+    }
+    printf("missing %ld, duplicated %ld, out of order %ld\n", missing, duplicated, out_of_order);
+    if (missing != 0 || duplicated != 0 || out_of_order != 0) {
+        return 1;
+    }
+
+    // A sleeping consumer wakes for a push long before its timeout
+    pthread_t pusher;
+    struct timespec start, end, timeout = {5, 0};
+    uint32_t value = 0;
+    pthread_create(&pusher, NULL, late_pusher, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int result = mpmc_ring_pop_wait(ring, &value, &timeout);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_join(pusher, NULL);
+    double waited = (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) / 1e9;
+    if (result != 0 || value != 7 || waited > 2.0) {
+        printf("Blocked pop did not wake for the push (waited %.2f s)\n", waited);
+        return 1;
+    }
+
+    // And gives up once the timeout passed on an empty ring
+    struct timespec short_timeout = {0, 20 * 1000 * 1000};
+    if (mpmc_ring_pop_wait(ring, &value, &short_timeout) != -1) {
+        printf("Pop on an empty ring did not time out\n");
+        return 1;
+    }
+
+    free(ring);
+    printf("MPMC ring test passed\n");
+    return 0;
+}
@@ -0,0 +1,85 @@
+//
+// Checks that random streams are reproducible, independent per actor and
+// stay in range, and that the bulk fills match one-at-a-time draws.
+//
+
+#include <stdio.h>
+#include "random.h"
+
+#define DRAWS 100000
+#define BUCKETS 10
+
+static int failures = 0;
+
+static void check(int condition, const char *message) {
+    if (!condition) {
+        printf("%s\n", message);
+        failures++;
+    }
+}
+
+int main(void) {
+    RandomStream a, b, other;
+
+    // Same seed, role and id: same sequence
+    random_stream_init(&a, 1234, RANDOM_CHEF, 3);
+    random_stream_init(&b, 1234, RANDOM_CHEF, 3);
+    int same = 1;
+    for (int i = 0; i < 1000; i++) {
+        same &= random_next(&a) == random_next(&b);
+    }
+    check(same, "Equal seeds gave different sequences");
+
+    // Another id or role must not replay the same stream
+    random_stream_init(&a, 1234, RANDOM_CHEF, 3);
+    random_stream_init(&other, 1234, RANDOM_CHEF, 4);
+    random_stream_init(&b, 1234, RANDOM_BAKER, 3);
+    uint64_t first = random_next(&a);
+    check(first != random_next(&other), "Chefs 3 and 4 share a stream");
+    check(first != random_next(&b), "Chef 3 and baker 3 share a stream");
+
+    // Bounded draws stay in range and are roughly uniform
+    int counts[BUCKETS] = {0};
+    int in_range = 1;
+    for (int i = 0; i < DRAWS; i++) {
+        uint32_t value = random_below(&a, BUCKETS);
+        in_range &= value < BUCKETS;
+        if (value < BUCKETS) {
+            counts[value]++;
+        }
+        int between = random_int(&a, -2, 2);
+        in_range &= between >= -2 && between <= 2;
+        float f = random_float(&a, 1.5f, 2.5f);
+        in_range &= f >= 1.5f && f < 2.5f;
+    }
+    check(in_range, "Draw out of range");
+    for (int i = 0; i < BUCKETS; i++) {
+        // Expected 10000 per bucket; 5 sigma is about 475
+        if (counts[i] < 9500 || counts[i] > 10500) {
+            printf("Bucket %d has %d draws\n", i, counts[i]);
+            failures++;
+        }
+    }
+
+    // Bulk fills draw exactly what single draws would
+    float bulk[64];
+    uint32_t bulk_below[64];
+    random_stream_init(&a, 99, RANDOM_CUSTOMER, 7);
+    random_stream_init(&b, 99, RANDOM_CUSTOMER, 7);
+    random_fill_float(&a, bulk, 64, 0, 10);
+    random_fill_below(&a, bulk_below, 64, 17);
+    int matches = 1;
+    for (int i = 0; i < 64; i++) {
+        matches &= bulk[i] == random_float(&b, 0, 10);
+    }
+    for (int i = 0; i < 64; i++) {
+        matches &= bulk_below[i] == random_below(&b, 17);
+    }
+    check(matches, "Bulk fill differs from single draws");
+
+    check(resolve_seed(42) == 42, "An explicit seed was replaced");
+    check(resolve_seed(0) != 0, "Seed 0 was not resolved");
+
+    printf("Random test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+//
+// One writer keeps rewriting a block of words that must all be equal while
+// reader threads copy it through the seqlock. Checks that no reader ever
+// sees a torn copy and that the readers made progress alongside the writer.
+// Then leaves a write unfinished, as a killed writer would, and checks that
+// a bounded read gives up and that the next writer repairs the sequence.
+//
+
+#include <pthread.h>
+#include <stdio.h>
+#include "seqlock.h"
+
+#define WORDS 32
+#define WRITES 2000000
+#define NUM_READERS 3
+
+typedef struct {
+    SeqLock seq;
+    long words[WORDS];
+} Block;
+
+static Block block;
+static int writer_done = 0;
+static long torn[NUM_READERS];
+static long copies[NUM_READERS];
+
+static void *writer(void *arg) {
+    (void) arg;
+    for (long value = 1; value <= WRITES; value++) {
+        seqlock_write_begin(&block.seq);
+        for (int i = 0; i < WORDS; i++) {
+            block.words[i] = value;
+        }
+        seqlock_write_end(&block.seq);
+    }
+    __atomic_store_n(&writer_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *reader(void *arg) {
+    int id = (int) (long) arg;
+    long last = 0;
+
+    while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE)) {
+        Block copy;
+        seqlock_read_copy(&block.seq, &copy, &block, sizeof(Block));
+        copies[id]++;
+
+        for (int i = 1; i < WORDS; i++) {
+            if (copy.words[i] != copy.words[0]) {
+                torn[id]++;
+                break;
+            }
+        }
+        // Published states only move forward
+        if (copy.words[0] < last) {
+            torn[id]++;
+        }
+        last = copy.words[0];
+    }
+    return NULL;
+}
+
+int main(void) {
+    pthread_t writer_thread, readers[NUM_READERS];
+    int failures = 0;
+
+    seqlock_init(&block.seq);
+    for (long i = 0; i < NUM_READERS; i++) {
+        pthread_create(&readers[i], NULL, reader, (void *) i);
+    }
+    pthread_create(&writer_thread, NULL, writer, NULL);
+
+    pthread_join(writer_thread, NULL);
+    for (int i = 0; i < NUM_READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+
+    for (int i = 0; i < NUM_READERS; i++) {
+        if (torn[i] != 0) {
+            printf("Reader %d saw %ld torn copies out of %ld\n", i, torn[i], copies[i]);
+            failures++;
+        }
+        if (copies[i] == 0) {
+            printf("Reader %d never got a copy\n", i);
+            failures++;
+        }
+    }
+    if (block.seq.sequence != 2 * WRITES) {
+        printf("Sequence is %u, expected %d\n", block.seq.sequence, 2 * WRITES);
+        failures++;
+    }
+
+    // A writer dies between begin and end
+    seqlock_write_begin(&block.seq);
+    Block copy;
+    if (seqlock_read_copy_bounded(&block.seq, copy.words, block.words, sizeof(block.words)) != -1) {
+        printf("Bounded read did not give up on a dead writer\n");
+        failures++;
+    }
+    seqlock_write_begin(&block.seq);
+    block.words[0] = -1;
+    seqlock_write_end(&block.seq);
+    if ((block.seq.sequence & 1) != 0 ||
+        seqlock_read_copy_bounded(&block.seq, copy.words, block.words, sizeof(block.words)) != 0 ||
+        copy.words[0] != -1) {
+        printf("Next writer did not repair the sequence\n");
+        failures++;
+    }
+
+    printf("Seqlock test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+//
+// Threads allocate, fill and free blocks of every class while others free
+// blocks handed to them through a ring, like sellers freeing the customers'
+// orders. Checks no two live blocks overlap, that freed blocks are reused
+// instead of carving the arena further, that a full arena fails cleanly,
+// and that a ref allocated in a forked child reads back in the parent.
+//
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "mpmc_ring.h"
+#include "shm_arena.h"
+
+#define TEST_SHM_NAME "/shm_arena_test"
+#define NUM_THREADS 4
+#define ROUNDS 200000
+#define LIVE 8                 // Blocks one thread holds at once
+#define HANDOFFS 100000
+
+static ShmArena *arena;
+static MpmcRing *handoff;
+static long corrupted = 0;
+
+static size_t random_size(unsigned int *seed) {
+    return 1 + (size_t) rand_r(seed) % (SHM_ARENA_MIN_BLOCK << (SHM_ARENA_CLASSES - 1)) / 2;
+}
+
+// Every live block is filled with its owner's byte; a block handed out
+// twice gets overwritten and fails the check on free
+static void *churn(void *arg) {
+    unsigned char owner = (unsigned char) (long) arg;
+    unsigned int seed = owner;
+    ShmRef refs[LIVE] = {0};
+    size_t sizes[LIVE] = {0};
+
+    for (int round = 0; round < ROUNDS; round++) {
+        int i = round % LIVE;
+        if (refs[i] != SHM_REF_NULL) {
+            unsigned char *data = shm_arena_ptr(arena, refs[i]);
+            for (size_t b = 0; b < sizes[i]; b++) {
+                if (data[b] != owner) {
+                    __atomic_add_fetch(&corrupted, 1, __ATOMIC_RELAXED);
+                    break;
+                }
+            }
+            shm_arena_free(arena, refs[i]);
+        }
+        sizes[i] = random_size(&seed);
+        refs[i] = shm_arena_alloc(arena, sizes[i]);
+        if (refs[i] == SHM_REF_NULL) {
+            __atomic_add_fetch(&corrupted, 1, __ATOMIC_RELAXED);
+            break;
+        }
+        memset(shm_arena_ptr(arena, refs[i]), owner, sizes[i]);
+    }
+    for (int i = 0; i < LIVE; i++) {
+        shm_arena_free(arena, refs[i]);
+    }
+    shm_arena_flush_cache(arena);
+    return NULL;
+}
+
+// Only allocates; the freeing thread's cache spills back to the free list
+static void *producer(void *arg) {
+    (void) arg;
+    for (uint32_t i = 0; i < HANDOFFS; i++) {
+        ShmRef ref = shm_arena_alloc(arena, 500);
+        if (ref == SHM_REF_NULL) {
+            __atomic_add_fetch(&corrupted, 1, __ATOMIC_RELAXED);
+            ref = 0;
+        } else {
+            *(uint32_t *) shm_arena_ptr(arena, ref) = i;
+        }
+        while (mpmc_ring_push(handoff, &ref) == -1) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    (void) arg;
+    struct timespec timeout = {1, 0};
+    for (uint32_t i = 0; i < HANDOFFS; i++) {
+        ShmRef ref;
+        if (mpmc_ring_pop_wait(handoff, &ref, &timeout) == -1) {
+            __atomic_add_fetch(&corrupted, 1, __ATOMIC_RELAXED);
+            break;
+        }
+        if (ref != SHM_REF_NULL && *(uint32_t *) shm_arena_ptr(arena, ref) != i) {
+            __atomic_add_fetch(&corrupted, 1, __ATOMIC_RELAXED);
+        }
+        shm_arena_free(arena, ref);
+    }
+    shm_arena_flush_cache(arena);
+    return NULL;
+}
+
+int main(void) {
+    size_t size = shm_arena_size(1 << 20);
+    arena = shm_arena_create(TEST_SHM_NAME, size);
+    if (arena == NULL) {
+        return 1;
+    }
+
+    // A ref allocated by another process reads back here
+    int fds[2];
+    if (pipe(fds) == -1) {
+        perror("pipe");
+        return 1;
+    }
+    pid_t child = fork();
+    if (child == 0) {
+        ShmArena *mapped = shm_arena_map(TEST_SHM_NAME);
+        ShmRef ref = mapped ? shm_arena_alloc(mapped, 100) : SHM_REF_NULL;
+        if (ref != SHM_REF_NULL) {
+            strcpy(shm_arena_ptr(mapped, ref), "from the child");
+        }
+        write(fds[1], &ref, sizeof(ref));
+        _exit(0);
+    }
+    ShmRef child_ref = SHM_REF_NULL;
+    read(fds[0], &child_ref, sizeof(child_ref));
+    waitpid(child, NULL, 0);
+    shm_unlink(TEST_SHM_NAME);
+    if (child_ref == SHM_REF_NULL || strcmp(shm_arena_ptr(arena, child_ref), "from the child") != 0) {
+        printf("Ref allocated in the child does not read back\n");
+        return 1;
+    }
+    shm_arena_free(arena, child_ref);
+
+    // That block now sits in this thread's cache; a forked child must not
+    // hand it out as well
+    child = fork();
+    if (child == 0) {
+        ShmRef ref = shm_arena_alloc(arena, 100);
+        write(fds[1], &ref, sizeof(ref));
+        _exit(0);
+    }
+    read(fds[0], &child_ref, sizeof(child_ref));
+    waitpid(child, NULL, 0);
+    ShmRef parent_ref = shm_arena_alloc(arena, 100);
+    if (child_ref == SHM_REF_NULL || child_ref == parent_ref) {
+        printf("Forked child reused a block cached by its parent\n");
+        return 1;
+    }
+    shm_arena_free(arena, parent_ref);
+    shm_arena_free(arena, child_ref);
+
+    if (shm_arena_block_size(1) != SHM_ARENA_MIN_BLOCK || shm_arena_block_size(100) != 128 ||
+        shm_arena_block_size(SHM_ARENA_MIN_BLOCK << SHM_ARENA_CLASSES) != 0) {
+        printf("Sizes map to the wrong classes\n");
+        return 1;
+    }
+
+    pthread_t threads[NUM_THREADS];
+    for (long i = 0; i < NUM_THREADS; i++) {
+        pthread_create(&threads[i], NULL, churn, (void *) (i + 1));
+    }
+    for (int i = 0; i < NUM_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (posix_memalign((void **) &handoff, CACHE_LINE, mpmc_ring_size(sizeof(ShmRef), 64)) != 0 ||
+        mpmc_ring_init(handoff, sizeof(ShmRef), 64) == -1) {
+        return 1;
+    }
+    pthread_t alloc_thread, free_thread;
+    pthread_create(&alloc_thread, NULL, producer, NULL);
+    pthread_create(&free_thread, NULL, consumer, NULL);
+    pthread_join(alloc_thread, NULL);
+    pthread_join(free_thread, NULL);
+    free(handoff);
+
+    // Close to a million allocations, yet only the blocks live at once were carved
+    size_t carved = shm_arena_carved(arena);
+    printf("corrupted %ld, carved %zu bytes\n", corrupted, carved);
+    if (corrupted != 0 || carved > size / 2) {
+        return 1;
+    }
+
+    // Running out fails cleanly, and freeing makes room again
+    static ShmRef refs[1 << 12];
+    int count = 0;
+    while (count < (1 << 12) && (refs[count] = shm_arena_alloc(arena, 1000)) != SHM_REF_NULL) {
+        count++;
+    }
+    if (count == 0 || count == (1 << 12)) {
+        printf("Arena did not run out (%d blocks)\n", count);
+        return 1;
+    }
+    for (int i = 0; i < count; i++) {
+        shm_arena_free(arena, refs[i]);
+    }
+    if (shm_arena_alloc(arena, 1000) == SHM_REF_NULL) {
+        printf("Freed blocks were not reused\n");
+        return 1;
+    }
+
+    shm_arena_unmap(arena);
+    printf("Shared memory arena test passed\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+//
+// Checks that every timer fires exactly on its tick, across all wheel levels,
+// and that cancelled or re-armed timers do not fire early.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "timer_wheel.h"
+
+#define NUM_TIMERS 500
+#define MAX_TICKS 20000
+
+static TimerWheel wheel;
+static TimerEntry timers[NUM_TIMERS];
+static long expected_tick[NUM_TIMERS];
+static long fired_tick[NUM_TIMERS];
+static long current;
+
+static void on_expire(int id, void *context) {
+    (void) context;
+    fired_tick[id] = current;
+}
+
+int main(void) {
+    if (timer_wheel_init(&wheel, timers, NUM_TIMERS) == -1) {
+        return 1;
+    }
+
+    srand(7);
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        expected_tick[i] = 1 + rand() % MAX_TICKS;
+        fired_tick[i] = -1;
+        timer_wheel_schedule(&wheel, i, expected_tick[i] * TIMER_WHEEL_TICK);
+    }
+
+    // Re-arm one timer and cancel another
+    expected_tick[0] = 42;
+    timer_wheel_schedule(&wheel, 0, 42 * TIMER_WHEEL_TICK);
+    timer_wheel_cancel(&wheel, 1);
+    expected_tick[1] = -1;
+
+    int failures = 0;
+    for (current = 1; current <= MAX_TICKS; current++) {
+        // Advance one tick at a time so the firing tick is known exactly
+        timer_wheel_advance(&wheel, current * TIMER_WHEEL_TICK + TIMER_WHEEL_TICK / 2, on_expire, NULL);
+
+        // Arm a late timer halfway through, relative to the current tick
+        if (current == 5000) {
+            expected_tick[2] = 5000 + 300;
+            fired_tick[2] = -1;
+            timer_wheel_schedule(&wheel, 2, expected_tick[2] * TIMER_WHEEL_TICK);
+        }
+    }
+
+    for (int i = 0; i < NUM_TIMERS; i++) {
+        if (fired_tick[i] != expected_tick[i]) {
+            printf("Timer %d fired at %ld, expected %ld\n", i, fired_tick[i], expected_tick[i]);
+            failures++;
+        }
+    }
+
+    timer_wheel_destroy(&wheel);
+
+    printf("Timer wheel test %s\n", failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+}